@@ -15,6 +15,32 @@ using namespace std;
 using namespace Loop;
 using namespace EOSX;
 
+/* Sum of nmodes sine modes along the coordinates a and b, with random-looking
+ * but reproducible phases that differ between the components c, and weights
+ * proportional to 1/n so that the sum lies within [-1, 1]. For a vector
+ * potential, mode n is divided by its wave number so that its curl has the
+ * same amplitude. Component c depends only on the other two coordinates, so
+ * that the vector field is divergence-free. */
+CCTK_DEVICE CCTK_HOST inline CCTK_REAL
+turbulent_modes(const CCTK_REAL a, const CCTK_REAL b, const int c,
+                const int nmodes, const CCTK_REAL wavelength,
+                const bool potential) {
+  constexpr CCTK_REAL golden = 0.6180339887498949;
+  CCTK_REAL norm = 0;
+  for (int n = 1; n <= nmodes; ++n)
+    norm += CCTK_REAL(1) / n;
+  CCTK_REAL sum = 0;
+  for (int n = 1; n <= nmodes; ++n) {
+    const CCTK_REAL k = 2 * M_PI * n / wavelength;
+    const CCTK_REAL phase_a = 2 * M_PI * fmod(golden * (6 * n + 2 * c), 1.0);
+    const CCTK_REAL phase_b =
+        2 * M_PI * fmod(golden * (6 * n + 2 * c + 1), 1.0);
+    const CCTK_REAL mode = (sin(k * a + phase_a) + sin(k * b + phase_b)) / 2;
+    sum += mode / (n * norm) / (potential ? k : 1);
+  }
+  return sum;
+}
+
 extern "C" void Tests3D_Initialize(CCTK_ARGUMENTS) {
   DECLARE_CCTK_ARGUMENTSX_Tests3D_Initialize;
   DECLARE_CCTK_PARAMETERS;
@@ -65,6 +91,49 @@ extern "C" void Tests3D_Initialize(CCTK_ARGUMENTS) {
         [=] CCTK_DEVICE(const PointDesc &p)
             CCTK_ATTRIBUTE_ALWAYS_INLINE { Avec_z(p.I) = 0.0; });
 
+  } else if (CCTK_EQUALS(test_case, "turbulence")) {
+
+    const int nmodes = turbulence_modes;
+    const CCTK_REAL wavelength = turbulence_wavelength;
+    const CCTK_REAL vel0 = turbulence_vel;
+    const CCTK_REAL B0 = turbulence_B;
+
+    grid.loop_all_device<1, 1, 1>(
+        grid.nghostzones,
+        [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+          rho(p.I) = 1.0;
+          velx(p.I) =
+              vel0 * turbulent_modes(p.y, p.z, 0, nmodes, wavelength, false);
+          vely(p.I) =
+              vel0 * turbulent_modes(p.z, p.x, 1, nmodes, wavelength, false);
+          velz(p.I) =
+              vel0 * turbulent_modes(p.x, p.y, 2, nmodes, wavelength, false);
+          press(p.I) = 1.0;
+          eps(p.I) = eos_th.eps_from_valid_rho_press_ye(rho(p.I), press(p.I),
+                                                        dummy_ye);
+        });
+
+    grid.loop_all_device<1, 0, 0>(
+        grid.nghostzones,
+        [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+          Avec_x(p.I) =
+              B0 * turbulent_modes(p.y, p.z, 3, nmodes, wavelength, true);
+        });
+
+    grid.loop_all_device<0, 1, 0>(
+        grid.nghostzones,
+        [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+          Avec_y(p.I) =
+              B0 * turbulent_modes(p.z, p.x, 4, nmodes, wavelength, true);
+        });
+
+    grid.loop_all_device<0, 0, 1>(
+        grid.nghostzones,
+        [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+          Avec_z(p.I) =
+              B0 * turbulent_modes(p.x, p.y, 5, nmodes, wavelength, true);
+        });
+
   } else {
     CCTK_ERROR("Test case not defined");
   }
@@ -0,0 +1,148 @@
+#include <loop_device.hxx>
+
+#include <cctk.h>
+#include <cctk_Arguments.h>
+#include <cctk_Parameters.h>
+
+#include <cmath>
+#include <seeds_utils.hxx>
+
+#include <eos.hxx>
+#include <eos_idealgas.hxx>
+
+namespace AsterSeeds {
+using namespace std;
+using namespace Loop;
+using namespace EOSX;
+
+// Difference between the numerical and the exact solution of the tests that
+// have one. The L1 norms of the errors are available via CarpetX's norm
+// output, see scripts/convergence.py.
+//
+// sound wave:  linear solution, i.e. exact up to terms of O(amplitude^2). The
+//              initial velocity perturbation splits into two waves moving
+//              with +-cs, which is periodic on x in [-1, 1].
+// Alfven wave: the circularly polarized wave of Del Zanna et al (2007),
+//              translated with the Alfven speed. The initial data are exact
+//              only for gl_gamma = 5/3. Periodic on x in [-0.5, 0.5].
+// magnetic loop advection: the initial loop translated with the fluid
+//              velocity, periodic with period loop_period in x and y.
+extern "C" void AsterSeeds_Errors(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTSX_AsterSeeds_Errors;
+  DECLARE_CCTK_PARAMETERS;
+
+  // The test cases are set up with an ideal gas EOS
+  eos::range rgeps(eps_min, eps_max), rgrho(rho_min, rho_max),
+      rgye(ye_min, ye_max);
+
+  const eos_idealgas eos_th(gl_gamma, particle_mass, rgeps, rgrho, rgye);
+  const CCTK_REAL dummy_ye = 0.5;
+  const CCTK_REAL t = cctk_time;
+
+  if (CCTK_EQUALS(test_case, "sound wave")) {
+    const CCTK_REAL rho0 = 1.0;
+    const CCTK_REAL press0 = 1.0;
+    const CCTK_REAL eps0 =
+        eos_th.eps_from_valid_rho_press_ye(rho0, press0, dummy_ye);
+    const CCTK_REAL cs =
+        eos_th.csnd_from_valid_rho_eps_ye(rho0, eps0, dummy_ye);
+
+    grid.loop_int_device<1, 1, 1>(
+        grid.nghostzones,
+        [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+          const CCTK_REAL rho_ex = rho0 - rho0 * amplitude / cs *
+                                              cos(M_PI * p.x) *
+                                              sin(M_PI * cs * t);
+          const CCTK_REAL velx_ex =
+              amplitude * sin(M_PI * p.x) * cos(M_PI * cs * t);
+          rho_error(p.I) = fabs(rho(p.I) - rho_ex);
+          velx_error(p.I) = fabs(velx(p.I) - velx_ex);
+          vely_error(p.I) = fabs(vely(p.I));
+          velz_error(p.I) = fabs(velz(p.I));
+          Bvecx_error(p.I) = fabs(Bvecx(p.I));
+          Bvecy_error(p.I) = fabs(Bvecy(p.I));
+          Bvecz_error(p.I) = fabs(Bvecz(p.I));
+        });
+
+  } else if (CCTK_EQUALS(test_case, "Alfven wave")) {
+    // Parameters of the initial data, see 1D_tests.cxx
+    const CCTK_REAL A0 = 1.0;
+    const CCTK_REAL va = 0.5;
+    const CCTK_REAL k = 2 * M_PI;
+    const CCTK_REAL rho0 = 1.0;
+    const CCTK_REAL press0 = 0.5;
+    const CCTK_REAL B0 = 1.0;
+
+    // Alfven speed of the wave, see Del Zanna et al (2007)
+    const CCTK_REAL eps0 =
+        eos_th.eps_from_valid_rho_press_ye(rho0, press0, dummy_ye);
+    const CCTK_REAL rhoh = rho0 * (1 + eps0) + press0;
+    const CCTK_REAL denom = rhoh + pow2(B0) * (1 + pow2(A0));
+    const CCTK_REAL vA = sqrt(
+        2 * pow2(B0) / denom /
+        (1 + sqrt(1 - pow2(2 * A0 * pow2(B0) / denom))));
+    static bool warned = false;
+    if (fabs(vA - va) > 1.0e-3 * va && !warned) {
+      warned = true;
+      CCTK_VWARN(CCTK_WARN_ALERT,
+                 "The Alfven wave initial data are not an exact solution "
+                 "for gl_gamma = %g (Alfven speed %g instead of %g)",
+                 double(gl_gamma), double(vA), double(va));
+    }
+
+    grid.loop_int_device<1, 1, 1>(
+        grid.nghostzones,
+        [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+          const CCTK_REAL phase = k * (p.x - vA * t);
+          rho_error(p.I) = fabs(rho(p.I) - rho0);
+          velx_error(p.I) = fabs(velx(p.I));
+          vely_error(p.I) = fabs(vely(p.I) + va * A0 * cos(phase));
+          velz_error(p.I) = fabs(velz(p.I) + va * A0 * sin(phase));
+          Bvecx_error(p.I) = fabs(Bvecx(p.I) - B0);
+          Bvecy_error(p.I) = fabs(Bvecy(p.I) - B0 * A0 * cos(phase));
+          Bvecz_error(p.I) = fabs(Bvecz(p.I) - B0 * A0 * sin(phase));
+        });
+
+  } else if (CCTK_EQUALS(test_case, "magnetic loop advection")) {
+    if (!CCTK_EQUALS(mag_loop_adv_type, "2D"))
+      CCTK_VERROR("The exact solution is only implemented for the 2D "
+                  "magnetic loop advection");
+
+    // Parameters of the initial data, see 2D_tests.cxx
+    const CCTK_REAL vx = 1. / 12.;
+    const CCTK_REAL vy = 1. / 24.;
+    const CCTK_REAL vz =
+        CCTK_EQUALS(mag_loop_adv_axial_vel, "non-zero") ? 1. / 24. : 0.;
+    const CCTK_REAL R_loop = 0.3;
+    const CCTK_REAL A_loop = 0.001;
+    const CCTK_REAL L = loop_period;
+
+    grid.loop_int_device<1, 1, 1>(
+        grid.nghostzones,
+        [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+          // Position relative to the centre of the nearest loop
+          CCTK_REAL x0 = p.x - vx * t;
+          CCTK_REAL y0 = p.y - vy * t;
+          x0 -= L * round(x0 / L);
+          y0 -= L * round(y0 / L);
+          const CCTK_REAL r_cyl = sqrt(pow2(x0) + pow2(y0));
+          CCTK_REAL Bx_ex = 0, By_ex = 0;
+          if (r_cyl < R_loop && r_cyl > 0) {
+            Bx_ex = -A_loop * y0 / r_cyl;
+            By_ex = A_loop * x0 / r_cyl;
+          }
+          rho_error(p.I) = fabs(rho(p.I) - 1.);
+          velx_error(p.I) = fabs(velx(p.I) - vx);
+          vely_error(p.I) = fabs(vely(p.I) - vy);
+          velz_error(p.I) = fabs(velz(p.I) - vz);
+          Bvecx_error(p.I) = fabs(Bvecx(p.I) - Bx_ex);
+          Bvecy_error(p.I) = fabs(Bvecy(p.I) - By_ex);
+          Bvecz_error(p.I) = fabs(Bvecz(p.I));
+        });
+
+  } else {
+    CCTK_VERROR("No exact solution is known for test case \"%s\"", test_case);
+  }
+}
+
+} // namespace AsterSeeds
@@ -0,0 +1,84 @@
+#include <loop_device.hxx>
+
+#include <AMReX_GpuContainers.H>
+
+#include <cctk.h>
+#include <cctk_Arguments.h>
+#include <cctk_Parameters.h>
+
+#include <cmath>
+#include <mutex>
+#include <set>
+
+#include "activity.hxx"
+#include "box_utils.hxx"
+
+namespace AsterX {
+using namespace std;
+using namespace Loop;
+
+/* Matter and magnetic fields move by less than a cell per substep of the time
+ * integrator, so the ghost zones of a box are a safety halo: a box whose cells
+ * and ghost zones are all atmosphere after one substep stays atmosphere during
+ * the next. The boxes are classified at the end of ODESolvers_PostStep, from
+ * the synchronized primitives, so that the flux kernels of the next RHS
+ * evaluation and the following con2prim see the same classification. The
+ * magnetic field has to be negligible as well, up to the round-off of the
+ * curl of the vector potential, so that no magnetic pressure drives the
+ * atmosphere. The atmosphere density is graded as in AsterX_Con2Prim. */
+
+namespace {
+
+/* quiescent boxes of this process */
+mutex activity_mutex;
+set<box_key_t> quiescent_boxes;
+
+} // namespace
+
+bool box_is_active(const cGH *cctkGH) {
+  DECLARE_CCTK_PARAMETERS;
+
+  if (!skip_atmosphere_boxes)
+    return true;
+  const lock_guard<mutex> lock(activity_mutex);
+  return !quiescent_boxes.count(box_key(cctkGH));
+}
+
+extern "C" void AsterX_Activity(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTSX_AsterX_Activity;
+  DECLARE_CCTK_PARAMETERS;
+
+  amrex::Gpu::DeviceScalar<int> active(0);
+  int *const active_ptr = active.dataPtr();
+  grid.loop_all_device<1, 1, 1>(
+      grid.nghostzones,
+      [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+        const CCTK_REAL radial_distance =
+            sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+        const CCTK_REAL rho_atm =
+            radial_distance > r_atmo
+                ? rho_abs_min * pow(r_atmo / radial_distance, n_rho_atmo)
+                : rho_abs_min;
+        const CCTK_REAL Bsq = Bvecx(p.I) * Bvecx(p.I) +
+                              Bvecy(p.I) * Bvecy(p.I) +
+                              Bvecz(p.I) * Bvecz(p.I);
+        if (rho(p.I) > rho_atm * (1 + atmo_tol) ||
+            Bsq > skip_atmosphere_Bsq_tol)
+          *active_ptr = 1;
+      });
+
+  const box_key_t key = box_key(cctkGH);
+  const bool is_active = active.dataValue();
+  const lock_guard<mutex> lock(activity_mutex);
+  if (is_active)
+    quiescent_boxes.erase(key);
+  else
+    quiescent_boxes.insert(key);
+}
+
+extern "C" void AsterX_Activity_Reset(CCTK_ARGUMENTS) {
+  const lock_guard<mutex> lock(activity_mutex);
+  quiescent_boxes.clear();
+}
+
+} // namespace AsterX
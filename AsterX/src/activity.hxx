@@ -0,0 +1,19 @@
+#ifndef ASTERX_ACTIVITY_HXX
+#define ASTERX_ACTIVITY_HXX
+
+#include <cctk.h>
+
+namespace AsterX {
+
+/* Whether the hydro variables of the current box are evolved. With
+ * skip_atmosphere_boxes, a box is quiescent if after the previous substep
+ * every cell including its ghost zones was atmosphere with a magnetic field
+ * below skip_atmosphere_Bsq_tol.
+ * Quiescent boxes skip the hydro fluxes, the source terms, the flux update of
+ * the RHS and con2prim, and their hydro RHS is zero. All boxes are active
+ * after a regrid and without skip_atmosphere_boxes. */
+bool box_is_active(const cGH *cctkGH);
+
+} // namespace AsterX
+
+#endif // #ifndef ASTERX_ACTIVITY_HXX
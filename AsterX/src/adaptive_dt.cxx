@@ -0,0 +1,131 @@
+#include <loop_device.hxx>
+
+#include <AMReX_GpuAtomic.H>
+#include <AMReX_GpuContainers.H>
+
+#include <cctk.h>
+#include <cctk_Arguments.h>
+#include <cctk_Parameters.h>
+
+#ifdef HAVE_CAPABILITY_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+
+#include "activity.hxx"
+#include "covered.hxx"
+#include "timers.hxx"
+
+namespace AsterX {
+using namespace std;
+using namespace Loop;
+
+/* Adaptive time step from the characteristic speeds amax and amin that
+ * AsterX_Fluxes stores on every face for the upwind-CT electric field. After
+ * each step, the largest signal crossing rate
+ *
+ *   sum_d max(amax_d, amin_d) / dx_d
+ *
+ * over all faces of all boxes and levels sets the time step of the next step,
+ * adaptive_dt_courant divided by that rate. The time step grows by at most a
+ * factor adaptive_dt_max_growth per step and is bounded by adaptive_dt_max.
+ * The maxima along the three directions are taken separately, which is more
+ * restrictive than the rate of any single cell.
+ *
+ * The speeds are those of the last RHS evaluation of the step, and do not
+ * include the speed of light of an evolved spacetime; use adaptive_dt_max to
+ * respect its Courant limit. All levels take the same time step, so the
+ * finest level with fast signals determines it. */
+
+namespace {
+
+/* largest rate of the local boxes since the last step */
+mutex cfl_mutex;
+CCTK_REAL cfl_rate = 0;
+bool have_cfl_rate = false;
+
+/* largest characteristic speed on the interior faces of a box along dir.
+ * Faces between two covered cells are skipped, ZeroFlux sets their speeds to
+ * placeholders. */
+template <int dir> CCTK_REAL max_face_speed(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTSX_AsterX_CFL_Speed;
+
+  const GF3D2<const CCTK_REAL> amax =
+      dir == 0 ? amax_xface : dir == 1 ? amax_yface : amax_zface;
+  const GF3D2<const CCTK_REAL> amin =
+      dir == 0 ? amin_xface : dir == 1 ? amin_yface : amin_zface;
+
+  const bool skip_covered = have_covered_cells(cctkGH);
+
+  amrex::Gpu::DeviceScalar<CCTK_REAL> speed(0);
+  CCTK_REAL *const speed_ptr = speed.dataPtr();
+  constexpr array<int, dim> face_centred = {!(dir == 0), !(dir == 1),
+                                            !(dir == 2)};
+  grid.loop_int_device<face_centred[0], face_centred[1], face_centred[2]>(
+      grid.nghostzones,
+      [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+        if (skip_covered && finer_covered(p.I) != 0 &&
+            finer_covered(p.I - p.DI[dir]) != 0)
+          return;
+        amrex::Gpu::Atomic::Max(speed_ptr, max(amax(p.I), amin(p.I)));
+      });
+  return speed.dataValue();
+}
+
+} // namespace
+
+extern "C" void AsterX_CFL_Speed(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTSX_AsterX_CFL_Speed;
+
+  /* The speeds of boxes that are not evolved are placeholders */
+  if (!box_is_active(cctkGH))
+    return;
+  const kernel_timer timer("AsterX_CFL_Speed", cctkGH);
+
+  const CCTK_REAL rate =
+      max_face_speed<0>(cctkGH) / CCTK_DELTA_SPACE(0) +
+      max_face_speed<1>(cctkGH) / CCTK_DELTA_SPACE(1) +
+      max_face_speed<2>(cctkGH) / CCTK_DELTA_SPACE(2);
+
+  const lock_guard<mutex> lock(cfl_mutex);
+  cfl_rate = max(cfl_rate, rate);
+  have_cfl_rate = true;
+}
+
+extern "C" void AsterX_CFL_Timestep(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS;
+  DECLARE_CCTK_PARAMETERS;
+
+  CCTK_REAL rate;
+  {
+    const lock_guard<mutex> lock(cfl_mutex);
+    rate = have_cfl_rate ? cfl_rate : -1;
+    cfl_rate = 0;
+    have_cfl_rate = false;
+  }
+#ifdef HAVE_CAPABILITY_MPI
+  MPI_Allreduce(MPI_IN_PLACE, &rate, 1,
+                sizeof(CCTK_REAL) == sizeof(double) ? MPI_DOUBLE : MPI_FLOAT,
+                MPI_MAX, MPI_COMM_WORLD);
+#endif
+  /* no box was evolved */
+  if (rate < 0)
+    return;
+
+  const CCTK_REAL old_dt = cctk_delta_time;
+  CCTK_REAL dt = adaptive_dt_max_growth * old_dt;
+  if (rate > 0)
+    dt = min(dt, adaptive_dt_courant / rate);
+  if (adaptive_dt_max > 0)
+    dt = min(dt, CCTK_REAL(adaptive_dt_max));
+  cctkGH->cctk_delta_time = dt;
+
+  if (adaptive_dt_verbose)
+    CCTK_VINFO("Iteration %d: maximum signal rate %g, time step %g -> %g",
+               cctk_iteration, double(rate), double(old_dt), double(dt));
+}
+
+} // namespace AsterX
@@ -0,0 +1,120 @@
+#include <AMReX_GpuDevice.H>
+
+#include <cctk.h>
+#include <cctk_Arguments.h>
+#include <cctk_Parameters.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include "fluxes.hxx"
+#include "kernel_model.hxx"
+
+namespace AsterX {
+using namespace std;
+
+extern "C" void AsterX_ComputedBstagFromA(CCTK_ARGUMENTS);
+extern "C" void AsterX_Con2Prim(CCTK_ARGUMENTS);
+extern "C" void AsterX_SourceTerms(CCTK_ARGUMENTS);
+extern "C" void AsterX_RHS(CCTK_ARGUMENTS);
+extern "C" void AsterX_Tmunu(CCTK_ARGUMENTS);
+
+/* Benchmark of the kernels on the initial data of each box. Every kernel is
+ * called once to warm up and then benchmark_repetitions times in a row. The
+ * kernels are called in the order of a time step, so that each one reads the
+ * output of the previous ones. The results of the kernels overwrite the
+ * initial data. */
+
+namespace {
+
+struct benchmark_kernel_t {
+  const char *name;
+  void (*run)(cGH *cctkGH);
+};
+
+const vector<benchmark_kernel_t> &benchmark_kernels() {
+  static const vector<benchmark_kernel_t> kernels{
+      {"AsterX_ComputedBstagFromA", AsterX_ComputedBstagFromA},
+      {"AsterX_Con2Prim", AsterX_Con2Prim},
+      {"AsterX_Fluxes/x", [](cGH *cctkGH) { CalcFluxesBenchmark(cctkGH, 0); }},
+      {"AsterX_Fluxes/y", [](cGH *cctkGH) { CalcFluxesBenchmark(cctkGH, 1); }},
+      {"AsterX_Fluxes/z", [](cGH *cctkGH) { CalcFluxesBenchmark(cctkGH, 2); }},
+      {"AsterX_Fluxes", [](cGH *cctkGH) { CalcFluxesBenchmark(cctkGH, -1); }},
+      {"AsterX_SourceTerms", AsterX_SourceTerms},
+      {"AsterX_RHS", AsterX_RHS},
+      {"AsterX_Tmunu", AsterX_Tmunu},
+  };
+  return kernels;
+}
+
+struct benchmark_stats_t {
+  long long calls = 0;
+  CCTK_REAL cells = 0;
+  CCTK_REAL seconds = 0;
+};
+
+/* accumulated over the local boxes, in the order of benchmark_kernels */
+mutex benchmark_mutex;
+vector<benchmark_stats_t> benchmark_stats;
+
+} // namespace
+
+extern "C" void AsterX_Benchmark(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS;
+  DECLARE_CCTK_PARAMETERS;
+
+  CCTK_REAL cells = 1;
+  for (int d = 0; d < cctk_dim; ++d)
+    cells *= cctk_lsh[d] - 1 - 2 * cctk_nghostzones[d];
+
+  const auto &kernels = benchmark_kernels();
+  vector<CCTK_REAL> seconds(kernels.size());
+  for (size_t n = 0; n < kernels.size(); ++n) {
+    kernels[n].run(cctkGH);
+    amrex::Gpu::streamSynchronize();
+    const auto start = chrono::steady_clock::now();
+    for (int rep = 0; rep < benchmark_repetitions; ++rep)
+      kernels[n].run(cctkGH);
+    amrex::Gpu::streamSynchronize();
+    const auto end = chrono::steady_clock::now();
+    seconds[n] = chrono::duration<CCTK_REAL>(end - start).count();
+  }
+
+  const lock_guard<mutex> lock(benchmark_mutex);
+  benchmark_stats.resize(kernels.size());
+  for (size_t n = 0; n < kernels.size(); ++n) {
+    benchmark_stats[n].calls += benchmark_repetitions;
+    benchmark_stats[n].cells += benchmark_repetitions * cells;
+    benchmark_stats[n].seconds += seconds[n];
+  }
+}
+
+extern "C" void AsterX_Benchmark_Output(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS;
+
+  const auto &kernels = benchmark_kernels();
+  const lock_guard<mutex> lock(benchmark_mutex);
+  if (benchmark_stats.empty())
+    return;
+
+  CCTK_VINFO("Kernel benchmark on process %d:", CCTK_MyProc(cctkGH));
+  CCTK_VINFO("  %-28s %8s %14s %12s %12s %9s %9s", "kernel", "calls", "cells",
+             "s/call", "Mzones/s", "GB/s", "GF/s");
+  for (size_t n = 0; n < kernels.size(); ++n) {
+    const auto &stats = benchmark_stats[n];
+    const CCTK_REAL seconds = max(stats.seconds, CCTK_REAL(1.0e-12));
+    kernel_cost_t cost;
+    kernel_cost(kernels[n].name, cost);
+    CCTK_VINFO("  %-28s %8lld %14.0f %12.6f %12.3f %9.3f %9.3f",
+               kernels[n].name, stats.calls, double(stats.cells),
+               double(stats.seconds / stats.calls),
+               double(stats.cells / seconds / 1.0e6),
+               double(stats.cells * cost.bytes() / seconds / 1.0e9),
+               double(stats.cells * cost.flops / seconds / 1.0e9));
+  }
+  benchmark_stats.clear();
+}
+
+} // namespace AsterX
@@ -0,0 +1,38 @@
+#ifndef ASTERX_BOX_UTILS_HXX
+#define ASTERX_BOX_UTILS_HXX
+
+#include <cctk.h>
+
+#include <array>
+
+namespace AsterX {
+
+/* Refinement level of the current box */
+inline int refinement_level(const cGH *cctkGH) {
+  int level = 0;
+  while ((1 << level) < cctkGH->cctk_levfac[0])
+    ++level;
+  return level;
+}
+
+/* Number of interior cells of the current box */
+inline CCTK_REAL interior_cells(const cGH *cctkGH) {
+  CCTK_REAL cells = 1;
+  for (int d = 0; d < cctkGH->cctk_dim; ++d)
+    cells *= cctkGH->cctk_lsh[d] - 1 - 2 * cctkGH->cctk_nghostzones[d];
+  return cells;
+}
+
+/* Level, lower bound and size of a box, which identify it until the next
+ * regrid */
+using box_key_t = std::array<int, 7>;
+
+inline box_key_t box_key(const cGH *cctkGH) {
+  return {refinement_level(cctkGH),
+          cctkGH->cctk_lbnd[0], cctkGH->cctk_lbnd[1], cctkGH->cctk_lbnd[2],
+          cctkGH->cctk_lsh[0],  cctkGH->cctk_lsh[1],  cctkGH->cctk_lsh[2]};
+}
+
+} // namespace AsterX
+
+#endif // #ifndef ASTERX_BOX_UTILS_HXX
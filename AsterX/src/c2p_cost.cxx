@@ -0,0 +1,101 @@
+#include <loop.hxx>
+
+#include <cctk.h>
+#include <cctk_Arguments.h>
+#include <cctk_Parameters.h>
+
+#ifdef HAVE_CAPABILITY_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+#include "box_utils.hxx"
+#include "c2p_cost.hxx"
+
+namespace AsterX {
+using namespace std;
+using namespace Loop;
+
+/* Load balance of the estimated cost of the boxes of the grid hierarchy.
+ * Most kernels cost the same in every cell, but the number of root-finding
+ * iterations of con2prim varies strongly: cells near the surface of a star,
+ * in strongly magnetized regions or where the first solver fails and the
+ * second one is called are much more expensive than atmosphere cells. Before
+ * every regrid, AsterX_C2PCost_Collect estimates the cost of every box as
+ *
+ *   (c2p_cost_cell + <con2prim iterations per cell>) * <interior cells>,
+ *
+ * in units of one root-finding iteration, with the iterations averaged over
+ * the recent steps. AsterX_C2PCost_Report compares the sums of these
+ * weights between the processes. Boxes that were not evolved since the last
+ * regrid, including newly created boxes, have c2p_cost_cell per cell. The
+ * driver does not take distribution weights, so the weights are only
+ * reported. */
+
+namespace {
+
+mutex c2p_cost_mutex;
+/* moving average of the con2prim iterations per cell of the local boxes */
+map<box_key_t, CCTK_REAL> box_iterations;
+/* weights of the local boxes before the next regrid */
+int local_boxes = 0;
+CCTK_REAL local_weight = 0;
+
+} // namespace
+
+void record_c2p_cost(const cGH *cctkGH, const CCTK_REAL iterations) {
+  DECLARE_CCTK_PARAMETERS;
+
+  const CCTK_REAL sample = iterations / interior_cells(cctkGH);
+  const box_key_t key = box_key(cctkGH);
+  const lock_guard<mutex> lock(c2p_cost_mutex);
+  const auto it = box_iterations.find(key);
+  if (it == box_iterations.end())
+    box_iterations[key] = sample;
+  else
+    it->second = c2p_cost_memory * it->second + (1 - c2p_cost_memory) * sample;
+}
+
+extern "C" void AsterX_C2PCost_Collect(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_PARAMETERS;
+
+  const lock_guard<mutex> lock(c2p_cost_mutex);
+  const auto it = box_iterations.find(box_key(cctkGH));
+  const CCTK_REAL iterations = it != box_iterations.end() ? it->second : 0;
+  ++local_boxes;
+  local_weight += (c2p_cost_cell + iterations) * interior_cells(cctkGH);
+}
+
+extern "C" void AsterX_C2PCost_Report(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS;
+
+  const lock_guard<mutex> lock(c2p_cost_mutex);
+  CCTK_REAL max_weight = local_weight;
+  CCTK_REAL total_weight = local_weight;
+#ifdef HAVE_CAPABILITY_MPI
+  const MPI_Datatype datatype =
+      sizeof(CCTK_REAL) == sizeof(double) ? MPI_DOUBLE : MPI_FLOAT;
+  MPI_Allreduce(MPI_IN_PLACE, &max_weight, 1, datatype, MPI_MAX,
+                MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &total_weight, 1, datatype, MPI_SUM,
+                MPI_COMM_WORLD);
+#endif
+  const CCTK_REAL mean_weight = total_weight / CCTK_nProcs(cctkGH);
+  CCTK_VINFO("Iteration %d: con2prim cost weight %.6g in %d boxes on process "
+             "%d; the most loaded process has %.3f times the mean weight",
+             cctk_iteration, double(local_weight), local_boxes,
+             CCTK_MyProc(cctkGH),
+             double(max_weight / max(mean_weight, CCTK_REAL(1.0e-30))));
+}
+
+extern "C" void AsterX_C2PCost_Reset(CCTK_ARGUMENTS) {
+  const lock_guard<mutex> lock(c2p_cost_mutex);
+  box_iterations.clear();
+  local_boxes = 0;
+  local_weight = 0;
+}
+
+} // namespace AsterX
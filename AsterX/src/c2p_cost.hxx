@@ -0,0 +1,17 @@
+#ifndef ASTERX_C2P_COST_HXX
+#define ASTERX_C2P_COST_HXX
+
+#include <cctk.h>
+
+namespace AsterX {
+
+/* Record the con2prim cost of the current box after AsterX_Con2Prim: the
+ * root-finding iterations summed over its interior cells, plus
+ * c2p_cost_failure for every cell where the first solver failed. With
+ * estimate_c2p_cost, the moving average of the iterations per cell weights
+ * the box in the load balance report before every regrid. */
+void record_c2p_cost(const cGH *cctkGH, CCTK_REAL iterations);
+
+} // namespace AsterX
+
+#endif // #ifndef ASTERX_C2P_COST_HXX
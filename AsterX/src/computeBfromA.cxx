@@ -5,6 +5,7 @@
 #include <cctk_Parameters.h>
 
 #include "utils.hxx"
+#include "timers.hxx"
 #include <array>
 
 struct metric {
@@ -19,9 +20,11 @@ template <int dir> void ComputeStaggeredB(CCTK_ARGUMENTS) {
   DECLARE_CCTK_ARGUMENTSX_AsterX_ComputedBstagFromA;
   DECLARE_CCTK_PARAMETERS;
 
-  const std::array dx{CCTK_DELTA_SPACE(0), CCTK_DELTA_SPACE(1),
-                      CCTK_DELTA_SPACE(2)};
-  const std::array idx{1 / dx[0], 1 / dx[1], 1 / dx[2]};
+  const vec<CCTK_REAL, dim> idx{1 / CCTK_DELTA_SPACE(0),
+                                1 / CCTK_DELTA_SPACE(1),
+                                1 / CCTK_DELTA_SPACE(2)};
+  const vec<GF3D2<const CCTK_REAL>, dim> gf_Avecs{Avec_x, Avec_y, Avec_z};
+  const vec<GF3D2<CCTK_REAL>, dim> gf_dBstags{dBx_stag, dBy_stag, dBz_stag};
 
   static_assert(dir >= 0 && dir < 3, "");
 
@@ -30,24 +33,9 @@ template <int dir> void ComputeStaggeredB(CCTK_ARGUMENTS) {
   grid.loop_int_device<face_centred[0], face_centred[1], face_centred[2]>(
       grid.nghostzones,
       [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
-        // Neighbouring "plus" and "minus" cell indices
-        const auto ipjk = p.I + p.DI[0];
-        const auto ijpk = p.I + p.DI[1];
-        const auto ijkp = p.I + p.DI[2];
-
-        if (dir == 0) {
-          /* dBx is curl(A) at (i-1/2,j,k) */
-          dBx_stag(p.I) = idx[1] * (Avec_z(ijpk) - Avec_z(p.I)) -
-                          idx[2] * (Avec_y(ijkp) - Avec_y(p.I));
-        } else if (dir == 1) {
-          /* dBy is curl(A) at (i,j-1/2,k) */
-          dBy_stag(p.I) = idx[2] * (Avec_x(ijkp) - Avec_x(p.I)) -
-                          idx[0] * (Avec_z(ipjk) - Avec_z(p.I));
-        } else if (dir == 2) {
-          /* dBz is curl(A) at (i,j,z-1/2) */
-          dBz_stag(p.I) = idx[0] * (Avec_y(ipjk) - Avec_y(p.I)) -
-                          idx[1] * (Avec_x(ijpk) - Avec_x(p.I));
-        }
+        /* dBx is curl(A) at (i-1/2,j,k), dBy at (i,j-1/2,k), dBz at
+         * (i,j,k-1/2) */
+        gf_dBstags(dir)(p.I) = calc_curlA(gf_Avecs, idx, p, dir, 0);
 
         // TODO: need to implement copy conditions?
       });
@@ -56,6 +44,7 @@ template <int dir> void ComputeStaggeredB(CCTK_ARGUMENTS) {
 extern "C" void AsterX_ComputedBstagFromA(CCTK_ARGUMENTS) {
   DECLARE_CCTK_ARGUMENTSX_AsterX_ComputedBstagFromA;
   DECLARE_CCTK_PARAMETERS;
+  const kernel_timer timer("AsterX_ComputedBstagFromA", cctkGH, true);
 
   ComputeStaggeredB<0>(cctkGH);
   ComputeStaggeredB<1>(cctkGH);
@@ -4,7 +4,10 @@
 
 #include <loop_device.hxx>
 
+#include <AMReX_GpuAtomic.H>
+
 #include <cmath>
+#include <optional>
 
 #include "c2p.hxx"
 #include "c2p_1DPalenzuela.hxx"
@@ -14,9 +17,13 @@
 #include <eos_polytropic.hxx>
 
 #include <eos.hxx>
-#include <eos_idealgas.hxx>
+#include <eos_dispatch.hxx>
 
 #include "utils.hxx"
+#include "activity.hxx"
+#include "c2p_cost.hxx"
+#include "covered.hxx"
+#include "timers.hxx"
 
 namespace AsterX {
 using namespace std;
@@ -24,7 +31,6 @@ using namespace Loop;
 using namespace EOSX;
 using namespace Con2PrimFactory;
 
-enum class eos_t { IdealGas, Hybrid, Tabulated };
 enum class c2p_first_t { Noble, Palenzuela };
 enum class c2p_second_t { Noble, Palenzuela };
 
@@ -54,12 +60,27 @@ void AsterX_Con2Prim_typeEoS(CCTK_ARGUMENTS, EOSIDType &eos_cold,
   }
 
   const smat<GF3D2<const CCTK_REAL>, 3> gf_g{gxx, gxy, gxz, gyy, gyz, gzz};
+  const vec<GF3D2<const CCTK_REAL>, 3> gf_dB{dBx, dBy, dBz};
+  const vec<GF3D2<const CCTK_REAL>, 3> gf_Avecs{Avec_x, Avec_y, Avec_z};
+  const vec<CCTK_REAL, 3> idx{1 / CCTK_DELTA_SPACE(0), 1 / CCTK_DELTA_SPACE(1),
+                              1 / CCTK_DELTA_SPACE(2)};
+  const bool skip_covered = have_covered_cells(cctkGH);
+
+  // Root-finding iterations of this box, see c2p_cost.hxx
+  optional<amrex::Gpu::DeviceScalar<CCTK_REAL> > c2p_iters;
+  if (estimate_c2p_cost)
+    c2p_iters.emplace(0);
+  CCTK_REAL *const c2p_iters_ptr = c2p_iters ? c2p_iters->dataPtr() : nullptr;
 
   // Loop over the interior of the grid
   cctk_grid.loop_int_device<
       1, 1, 1>(grid.nghostzones, [=] CCTK_DEVICE(
                                      const PointDesc
                                          &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+    // Covered cells are restricted from the finer level, see covered.hxx
+    if (skip_covered && finer_covered(p.I) != 0)
+      return;
+
     // Setting up atmosphere
     CCTK_REAL rho_atm = 0.0;   // dummy initialization
     CCTK_REAL press_atm = 0.0; // dummy initialization
@@ -106,11 +127,20 @@ void AsterX_Con2Prim_typeEoS(CCTK_ARGUMENTS, EOSIDType &eos_cold,
     const vec<CCTK_REAL, 3> v_low = calc_contraction(glo, v_up);
     CCTK_REAL wlor = calc_wlorentz(v_low, v_up);
 
-    vec<CCTK_REAL, 3> Bup{dBx(p.I) / sqrt_detg, dBy(p.I) / sqrt_detg,
-                          dBz(p.I) / sqrt_detg};
+    /* Densitized magnetic field, either from AsterX_ComputedBFromdBstag or
+     * directly from the curl of the vector potential */
+    const vec<CCTK_REAL, 3> dBvec([&](int i) ARITH_INLINE {
+      return fuse_curlA_con2prim ? calc_dB_from_A(gf_Avecs, idx, p, i)
+                                 : gf_dB(i)(p.I);
+    });
 
-    CCTK_REAL dummy_Ye = 0.5;
-    CCTK_REAL dummy_dYe = 0.5;
+    vec<CCTK_REAL, 3> Bup{dBvec(0) / sqrt_detg, dBvec(1) / sqrt_detg,
+                          dBvec(2) / sqrt_detg};
+
+    // Ye is not evolved; every EOS call of AsterX uses Ye_atmo, so that the
+    // cell and face states are consistent with a tabulated EOS
+    const CCTK_REAL dummy_Ye = Ye_atmo;
+    const CCTK_REAL dummy_dYe = dens(p.I) * Ye_atmo;
     prim_vars pv;
     prim_vars pv_seeds{saved_rho(p.I), saved_eps(p.I), dummy_Ye, press(p.I),
                        v_up,           wlor,           Bup};
@@ -119,12 +149,10 @@ void AsterX_Con2Prim_typeEoS(CCTK_ARGUMENTS, EOSIDType &eos_cold,
                  {momx(p.I), momy(p.I), momz(p.I)},
                  tau(p.I),
                  dummy_dYe,
-                 {dBx(p.I), dBy(p.I), dBz(p.I)}};
+                 {dBvec(0), dBvec(1), dBvec(2)}};
 
     if (dens(p.I) <= sqrt_detg * rho_atmo_cut) {
-      cv.dBvec(0) = dBx(p.I); // densitized
-      cv.dBvec(1) = dBy(p.I);
-      cv.dBvec(2) = dBz(p.I);
+      cv.dBvec = dBvec; // densitized
       pv.Bvec = cv.dBvec / sqrt_detg;
       atmo.set(pv, cv, glo);
       atmo.set(pv_seeds);
@@ -134,14 +162,19 @@ void AsterX_Con2Prim_typeEoS(CCTK_ARGUMENTS, EOSIDType &eos_cold,
     c2p_report rep_first;
     c2p_report rep_second;
 
+    // The temperature of the previous step is the initial guess for the
+    // temperature inversions of the EOS. HydroBaseX::temperature is a
+    // dependent of tau and is invalid here, so the saved copy is used.
+    const auto &eos_pt = eos_th.with_temp_guess(saved_temperature(p.I));
+
     // Calling the first C2P
     switch (c2p_fir) {
     case c2p_first_t::Noble: {
-      c2p_Noble.solve(eos_th, pv, pv_seeds, cv, glo, rep_first);
+      c2p_Noble.solve(eos_pt, pv, pv_seeds, cv, glo, rep_first);
       break;
     }
     case c2p_first_t::Palenzuela: {
-      c2p_Pal.solve(eos_th, pv, pv_seeds, cv, glo, rep_first);
+      c2p_Pal.solve(eos_pt, pv, pv_seeds, cv, glo, rep_first);
       break;
     }
     default:
@@ -155,11 +188,11 @@ void AsterX_Con2Prim_typeEoS(CCTK_ARGUMENTS, EOSIDType &eos_cold,
       // Calling the second C2P
       switch (c2p_sec) {
       case c2p_second_t::Noble: {
-        c2p_Noble.solve(eos_th, pv, pv_seeds, cv, glo, rep_second);
+        c2p_Noble.solve(eos_pt, pv, pv_seeds, cv, glo, rep_second);
         break;
       }
       case c2p_second_t::Palenzuela: {
-        c2p_Pal.solve(eos_th, pv, pv_seeds, cv, glo, rep_second);
+        c2p_Pal.solve(eos_pt, pv, pv_seeds, cv, glo, rep_second);
         break;
       }
       default:
@@ -167,6 +200,13 @@ void AsterX_Con2Prim_typeEoS(CCTK_ARGUMENTS, EOSIDType &eos_cold,
       }
     }
 
+    if (c2p_iters_ptr) {
+      CCTK_REAL iters = rep_first.iters;
+      if (rep_first.failed())
+        iters += c2p_cost_failure + rep_second.iters;
+      amrex::Gpu::Atomic::Add(c2p_iters_ptr, iters);
+    }
+
     if (rep_first.failed() && rep_second.failed()) {
       printf("Second C2P failed too :( :( \n");
       rep_second.debug_message();
@@ -191,7 +231,7 @@ void AsterX_Con2Prim_typeEoS(CCTK_ARGUMENTS, EOSIDType &eos_cold,
             "Bvecz = %26.16e \n "
             "Avec_x = %26.16e \n Avec_y = %26.16e \n Avec_z = %26.16e \n ",
             cctk_iteration, p.x, p.y, p.z, dens(p.I), tau(p.I), momx(p.I),
-            momy(p.I), momz(p.I), dBx(p.I), dBy(p.I), dBz(p.I), pv.rho, pv.eps,
+            momy(p.I), momz(p.I), dBvec(0), dBvec(1), dBvec(2), pv.rho, pv.eps,
             pv.press, pv.vel(0), pv.vel(1), pv.vel(2), pv.Bvec(0), pv.Bvec(1),
             pv.Bvec(2),
             // rho(p.I), eps(p.I), press(p.I), velx(p.I), vely(p.I),
@@ -200,9 +240,7 @@ void AsterX_Con2Prim_typeEoS(CCTK_ARGUMENTS, EOSIDType &eos_cold,
       }
 
       // set to atmo
-      cv.dBvec(0) = dBx(p.I);
-      cv.dBvec(1) = dBy(p.I);
-      cv.dBvec(2) = dBz(p.I);
+      cv.dBvec = dBvec;
       pv.Bvec = cv.dBvec / sqrt_detg;
       atmo.set(pv, cv, glo);
 
@@ -219,6 +257,8 @@ void AsterX_Con2Prim_typeEoS(CCTK_ARGUMENTS, EOSIDType &eos_cold,
     pv.scatter(rho(p.I), eps(p.I), dummy_Ye, press(p.I), velx(p.I), vely(p.I),
                velz(p.I), wlor, Bvecx(p.I), Bvecy(p.I), Bvecz(p.I), Ex, Ey, Ez);
 
+    temperature(p.I) = eos_pt.temp_from_valid_rho_eps_ye(pv.rho, pv.eps, pv.Ye);
+
     zvec_x(p.I) = wlor * pv.vel(0); 
     zvec_y(p.I) = wlor * pv.vel(1);
     zvec_z(p.I) = wlor * pv.vel(2);
@@ -237,56 +277,59 @@ void AsterX_Con2Prim_typeEoS(CCTK_ARGUMENTS, EOSIDType &eos_cold,
     saved_vely(p.I) = vely(p.I);
     saved_velz(p.I) = velz(p.I);
     saved_eps(p.I) = eps(p.I);
+    saved_temperature(p.I) = temperature(p.I);
   }); // Loop
+
+  if (c2p_iters)
+    record_c2p_cost(cctkGH, c2p_iters->dataValue());
 }
 
 extern "C" void AsterX_Con2Prim(CCTK_ARGUMENTS) {
   DECLARE_CCTK_ARGUMENTS_AsterX_Con2Prim;
   DECLARE_CCTK_PARAMETERS;
+  // The primitives of boxes that are not evolved stay atmosphere
+  if (!box_is_active(cctkGH))
+    return;
+  const kernel_timer timer("AsterX_Con2Prim", cctkGH, true);
+
+  dispatch_eos_3p([&](const auto &eos_th) {
+    AsterX_Con2Prim_typeEoS(CCTK_PASS_CTOC, get_eos_cold(), eos_th);
+  });
+}
 
-  // defining EOS objects
-  eos_t eostype;
-  eos::range rgeps(eps_min, eps_max), rgrho(rho_min, rho_max),
-      rgye(ye_min, ye_max);
-
-  if (CCTK_EQUALS(evolution_eos, "IdealGas")) {
-    eostype = eos_t::IdealGas;
-  } else if (CCTK_EQUALS(evolution_eos, "Hybrid")) {
-    eostype = eos_t::Hybrid;
-  } else if (CCTK_EQUALS(evolution_eos, "Tabulated")) {
-    eostype = eos_t::Tabulated;
-  } else {
-    CCTK_ERROR("Unknown value for parameter \"evolution_eos\"");
-  }
+template <typename EOSType>
+void AsterX_Temperature_Initial_typeEoS(CCTK_ARGUMENTS, EOSType &eos_th) {
+  DECLARE_CCTK_ARGUMENTSX_AsterX_Temperature_Initial;
+  DECLARE_CCTK_PARAMETERS;
+
+  // TODO: use Ye from HydroBaseX once it is evolved, see AsterX_Con2Prim
+  const CCTK_REAL dummy_Ye = Ye_atmo;
 
-  switch (eostype) {
-  case eos_t::IdealGas: {
-    CCTK_REAL n = 1 / (poly_gamma - 1); // Polytropic index
-    CCTK_REAL rmd_p = pow(poly_k, -n);  // Polytropic density scale
+  grid.loop_int_device<1, 1, 1>(
+      grid.nghostzones,
+      [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+        temperature(p.I) =
+            eos_th.temp_from_valid_rho_eps_ye(rho(p.I), eps(p.I), dummy_Ye);
+      });
+}
 
-    const eos_polytrope eos_cold(n, rmd_p, rho_max);
-    const eos_idealgas eos_th(gl_gamma, particle_mass, rgeps, rgrho, rgye);
+extern "C" void AsterX_Temperature_Initial(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS_AsterX_Temperature_Initial;
 
-    AsterX_Con2Prim_typeEoS(CCTK_PASS_CTOC, eos_cold, eos_th);
-    break;
-  }
-  case eos_t::Hybrid: {
-    CCTK_ERROR("Hybrid EOS is not yet supported");
-    break;
-  }
-  case eos_t::Tabulated: {
-    CCTK_ERROR("Tabulated EOS is not yet supported");
-    break;
-  }
-  default:
-    assert(0);
-  }
+  dispatch_eos_3p([&](const auto &eos_th) {
+    AsterX_Temperature_Initial_typeEoS(CCTK_PASS_CTOC, eos_th);
+  });
 }
 
-extern "C" void AsterX_Con2Prim_Interpolate_Failed(CCTK_ARGUMENTS) {
+template <typename EOSType>
+void AsterX_Con2Prim_Interpolate_Failed_typeEoS(CCTK_ARGUMENTS,
+                                                EOSType &eos_th) {
   DECLARE_CCTK_ARGUMENTSX_AsterX_Con2Prim_Interpolate_Failed;
   DECLARE_CCTK_PARAMETERS;
 
+  // TODO: use Ye from HydroBaseX once it is evolved, see AsterX_Con2Prim
+  const CCTK_REAL dummy_Ye = Ye_atmo;
+
   const smat<GF3D2<const CCTK_REAL>, 3> gf_g{gxx, gxy, gxz, gyy, gyz, gzz};
   const vec<GF3D2<CCTK_REAL>, 6> gf_prims{rho, velx, vely, velz, eps, press};
   const vec<GF3D2<CCTK_REAL>, 5> gf_cons{dens, momx, momy, momz, tau};
@@ -316,7 +359,8 @@ extern "C" void AsterX_Con2Prim_Interpolate_Failed(CCTK_ARGUMENTS) {
           vely(p.I) = calc_avg_neighbors(flag_nbs, vely_nbs, saved_vely_nbs);
           velz(p.I) = calc_avg_neighbors(flag_nbs, velz_nbs, saved_velz_nbs);
           eps(p.I) = calc_avg_neighbors(flag_nbs, eps_nbs, saved_eps_nbs);
-          press(p.I) = (gl_gamma - 1) * eps(p.I) * rho(p.I);
+          press(p.I) =
+              eos_th.press_from_valid_rho_eps_ye(rho(p.I), eps(p.I), dummy_Ye);
 
           /* reset flag */
           con2prim_flag(p.I) = 1;
@@ -345,4 +389,14 @@ extern "C" void AsterX_Con2Prim_Interpolate_Failed(CCTK_ARGUMENTS) {
       });
 }
 
+extern "C" void AsterX_Con2Prim_Interpolate_Failed(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS_AsterX_Con2Prim_Interpolate_Failed;
+  const kernel_timer timer("AsterX_Con2Prim_Interpolate_Failed", cctkGH,
+                           true);
+
+  dispatch_eos_3p([&](const auto &eos_th) {
+    AsterX_Con2Prim_Interpolate_Failed_typeEoS(CCTK_PASS_CTOC, eos_th);
+  });
+}
+
 } // namespace AsterX
@@ -0,0 +1,223 @@
+#include <loop_device.hxx>
+
+#include <AMReX_GpuAtomic.H>
+#include <AMReX_GpuContainers.H>
+
+#include <cctk.h>
+#include <cctk_Arguments.h>
+#include <cctk_Parameters.h>
+
+#ifdef HAVE_CAPABILITY_MPI
+#include <mpi.h>
+#endif
+
+#include <array>
+#include <cfloat>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "box_utils.hxx"
+#include "covered.hxx"
+
+namespace AsterX {
+using namespace std;
+using namespace Loop;
+
+/* Mask of the cells of a coarse level that are covered by the next finer
+ * level. CarpetX restricts all grid functions from the finer level at the
+ * end of each step, including the primitives, so the coarse level does not
+ * need to evolve the covered cells. The driver does not publish the grid
+ * hierarchy, so after each regrid every process collects the extents of its
+ * boxes, and these are exchanged between all processes. POSTREGRID only
+ * traverses the levels that changed, so the boxes are kept per level and only
+ * those of the regridded levels are replaced. Every exchange of a level
+ * increases its generation; a box whose mask was marked for an older
+ * generation of the next finer level is marked again before the next step.
+ *
+ * The skipped cells keep their values of the beginning of the step during
+ * the substeps of the time integrator. Their error reaches one stencil width
+ * further into the computed cells at every RHS evaluation, and the cells next
+ * to the boundary of the finer level have to be correct at every substep for
+ * the prolongation into its ghost zones and for the fluxes at its boundary.
+ * The buffer of covered_buffer cells absorbs this error, and is restricted
+ * over at the end of the step as well. */
+
+namespace {
+
+/* level, lower and upper corner of the interior of a box */
+using box_extent_t = array<CCTK_REAL, 1 + 2 * dim>;
+
+mutex covered_mutex;
+/* boxes of this process since the last exchange */
+vector<box_extent_t> local_boxes;
+/* boxes of all processes, by level */
+map<int, vector<box_extent_t> > all_boxes;
+/* number of exchanges that regridded a level */
+map<int, int> level_generation;
+/* generation of the next finer level for which a local box was marked */
+map<box_key_t, int> marked_generation;
+
+int generation(const int level) {
+  const auto it = level_generation.find(level);
+  return it == level_generation.end() ? 0 : it->second;
+}
+
+} // namespace
+
+bool have_covered_cells(const cGH *cctkGH) {
+  DECLARE_CCTK_PARAMETERS;
+
+  if (!skip_covered_cells)
+    return false;
+  const lock_guard<mutex> lock(covered_mutex);
+  return all_boxes.count(refinement_level(cctkGH) + 1);
+}
+
+extern "C" void AsterX_Covered_Collect(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTSX_AsterX_Covered_Collect;
+
+  vector<CCTK_REAL> extent_host(2 * dim);
+  for (int d = 0; d < dim; ++d) {
+    extent_host[d] = DBL_MAX;
+    extent_host[dim + d] = -DBL_MAX;
+  }
+  amrex::Gpu::DeviceVector<CCTK_REAL> extent(2 * dim);
+  amrex::Gpu::copy(amrex::Gpu::hostToDevice, extent_host.begin(),
+                   extent_host.end(), extent.begin());
+  CCTK_REAL *const extent_ptr = extent.data();
+  grid.loop_int_device<1, 1, 1>(
+      grid.nghostzones,
+      [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+        for (int d = 0; d < dim; ++d) {
+          amrex::Gpu::Atomic::Min(&extent_ptr[d], p.X[d] - p.DX[d] / 2);
+          amrex::Gpu::Atomic::Max(&extent_ptr[dim + d], p.X[d] + p.DX[d] / 2);
+        }
+      });
+  amrex::Gpu::copy(amrex::Gpu::deviceToHost, extent.begin(), extent.end(),
+                   extent_host.begin());
+
+  box_extent_t box;
+  box[0] = refinement_level(cctkGH);
+  for (int n = 0; n < 2 * dim; ++n)
+    box[1 + n] = extent_host[n];
+
+  const lock_guard<mutex> lock(covered_mutex);
+  local_boxes.push_back(box);
+}
+
+extern "C" void AsterX_Covered_Gather(CCTK_ARGUMENTS) {
+  const lock_guard<mutex> lock(covered_mutex);
+
+  /* levels traversed by this regrid on any process */
+  unsigned long long regridded = 0;
+  for (const auto &box : local_boxes)
+    regridded |= 1ULL << int(box[0]);
+
+  constexpr int box_size = tuple_size<box_extent_t>::value;
+  vector<box_extent_t> boxes;
+#ifdef HAVE_CAPABILITY_MPI
+  MPI_Allreduce(MPI_IN_PLACE, &regridded, 1, MPI_UNSIGNED_LONG_LONG, MPI_BOR,
+                MPI_COMM_WORLD);
+  const MPI_Datatype datatype =
+      sizeof(CCTK_REAL) == sizeof(double) ? MPI_DOUBLE : MPI_FLOAT;
+  int nprocs;
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+  const int count = box_size * local_boxes.size();
+  vector<int> counts(nprocs), offsets(nprocs);
+  MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT,
+                MPI_COMM_WORLD);
+  int total = 0;
+  for (int proc = 0; proc < nprocs; ++proc) {
+    offsets[proc] = total;
+    total += counts[proc];
+  }
+  boxes.resize(total / box_size);
+  MPI_Allgatherv(local_boxes.data(), count, datatype, boxes.data(),
+                 counts.data(), offsets.data(), datatype, MPI_COMM_WORLD);
+#else
+  boxes = local_boxes;
+#endif
+  local_boxes.clear();
+
+  const auto was_regridded = [&](const int level) {
+    return bool(regridded >> level & 1);
+  };
+  for (int level = 0; level < 64; ++level) {
+    if (!was_regridded(level))
+      continue;
+    all_boxes.erase(level);
+    ++level_generation[level];
+  }
+  for (const auto &box : boxes)
+    all_boxes[int(box[0])].push_back(box);
+  for (auto it = marked_generation.begin(); it != marked_generation.end();)
+    it = was_regridded(it->first[0]) ? marked_generation.erase(it) : next(it);
+}
+
+void MarkCovered(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTSX_AsterX_Covered_Mark;
+  DECLARE_CCTK_PARAMETERS;
+
+  /* boxes of the next finer level, shrunk by the buffer */
+  vector<CCTK_REAL> finer_host;
+  if (skip_covered_cells) {
+    const int finer_level = refinement_level(cctkGH) + 1;
+    const lock_guard<mutex> lock(covered_mutex);
+    marked_generation[box_key(cctkGH)] = generation(finer_level);
+    const auto it = all_boxes.find(finer_level);
+    if (it != all_boxes.end())
+      for (const auto &box : it->second) {
+        for (int d = 0; d < dim; ++d)
+          finer_host.push_back(box[1 + d] +
+                               covered_buffer * CCTK_DELTA_SPACE(d));
+        for (int d = 0; d < dim; ++d)
+          finer_host.push_back(box[1 + dim + d] -
+                               covered_buffer * CCTK_DELTA_SPACE(d));
+      }
+  }
+
+  const int nfiner = finer_host.size() / (2 * dim);
+  amrex::Gpu::DeviceVector<CCTK_REAL> finer(finer_host.size());
+  amrex::Gpu::copy(amrex::Gpu::hostToDevice, finer_host.begin(),
+                   finer_host.end(), finer.begin());
+  const CCTK_REAL *const finer_ptr = finer.data();
+  grid.loop_all_device<1, 1, 1>(
+      grid.nghostzones,
+      [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+        /* The boundaries of the shrunk boxes lie on faces of this level */
+        bool covered = false;
+        for (int b = 0; b < nfiner && !covered; ++b) {
+          const CCTK_REAL *const box = &finer_ptr[2 * dim * b];
+          bool inside = true;
+          for (int d = 0; d < dim; ++d)
+            inside &= p.X[d] > box[d] && p.X[d] < box[dim + d];
+          covered = inside;
+        }
+        finer_covered(p.I) = covered;
+      });
+}
+
+extern "C" void AsterX_Covered_Mark(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTSX_AsterX_Covered_Mark;
+
+  MarkCovered(cctkGH);
+}
+
+/* Mark the boxes of levels that were not regridded themselves, but whose next
+ * finer level was */
+extern "C" void AsterX_Covered_Update(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTSX_AsterX_Covered_Update;
+
+  {
+    const int finer_level = refinement_level(cctkGH) + 1;
+    const lock_guard<mutex> lock(covered_mutex);
+    const auto it = marked_generation.find(box_key(cctkGH));
+    if (it != marked_generation.end() &&
+        it->second == generation(finer_level))
+      return;
+  }
+  MarkCovered(cctkGH);
+}
+
+} // namespace AsterX
@@ -0,0 +1,21 @@
+#ifndef ASTERX_COVERED_HXX
+#define ASTERX_COVERED_HXX
+
+#include <cctk.h>
+
+namespace AsterX {
+
+/* Whether the current level skips the hydro update in the cells marked by
+ * the grid function finer_covered. With skip_covered_cells, a cell of a
+ * coarse level is covered if it lies under a box of the next finer level,
+ * more than covered_buffer cells away from the boundary of that box. Covered
+ * cells are overwritten by restriction at the end of every step, so they skip
+ * the fluxes, the source terms, the flux update of the RHS and con2prim, and
+ * their hydro RHS is zero. T_munu is still computed from their primitives,
+ * which are restricted as well, so that it is valid on the whole level. The
+ * finest level has no covered cells. */
+bool have_covered_cells(const cGH *cctkGH);
+
+} // namespace AsterX
+
+#endif // #ifndef ASTERX_COVERED_HXX
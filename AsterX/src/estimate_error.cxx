@@ -9,6 +9,7 @@
 #include <cmath>
 
 #include "estimate_error.hxx"
+#include "timers.hxx"
 
 namespace AsterX {
 using namespace std;
@@ -70,6 +71,7 @@ extern "C" void AsterX_EstimateError_Setup(CCTK_ARGUMENTS) {
 extern "C" void AsterX_EstimateError(CCTK_ARGUMENTS) {
   DECLARE_CCTK_ARGUMENTSX_AsterX_EstimateError;
   DECLARE_CCTK_PARAMETERS;
+  const kernel_timer timer("AsterX_EstimateError", cctkGH);
 
   Loop::GF3D2<const CCTK_REAL> *regridVars =
       (Loop::GF3D2<const CCTK_REAL> *)amrex::The_Arena()->alloc(
@@ -83,7 +83,8 @@ CCTK_DEVICE inline T calc_deriv_2nd_norm(const Loop::GF3D2<const T> &gf,
 }
 
 /* functions for interpreting pars */
-void read_stream(vector<string> &groups, istringstream &groupstream) {
+inline void read_stream(vector<string> &groups,
+                        istringstream &groupstream) {
   string delim = " \n", group;
   while (getline(groupstream, group)) {
     size_t prev = 0, pos;
@@ -97,7 +98,7 @@ void read_stream(vector<string> &groups, istringstream &groupstream) {
   }
 }
 
-array<int, Loop::dim> get_group_indextype(const int gi) {
+inline array<int, Loop::dim> get_group_indextype(const int gi) {
   DECLARE_CCTK_PARAMETERS;
 
   assert(gi >= 0);
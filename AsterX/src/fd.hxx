@@ -31,6 +31,21 @@ calc_fd2_v2v_oneside(const GF3D2<const T> &gf, const PointDesc &p,
          (0.5 / p.DX[dir]);
 }
 
+// FD2: product of two vertex centered inputs, vertex centered output,
+// oneside stencil. p is a PointDesc, or any point with the members I, DI and
+// DX (see test.hxx)
+template <typename T, typename PointType>
+CCTK_DEVICE CCTK_HOST CCTK_ATTRIBUTE_ALWAYS_INLINE inline T
+calc_fd2_v2v_oneside_prod(const GF3D2<const T> &gf1, const GF3D2<const T> &gf2,
+                          const PointType &p, const int dir, const int sign) {
+  const auto I1 = p.I + sign * p.DI[dir];
+  const auto I2 = p.I + 2 * sign * p.DI[dir];
+  return -sign *
+         (gf1(I2) * gf2(I2) - 4.0 * gf1(I1) * gf2(I1) +
+          3.0 * gf1(p.I) * gf2(p.I)) *
+         (0.5 / p.DX[dir]);
+}
+
 // FD2: cell centered input, cell centered output
 template <typename T>
 CCTK_DEVICE CCTK_HOST CCTK_ATTRIBUTE_ALWAYS_INLINE inline T
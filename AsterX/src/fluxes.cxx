@@ -12,9 +12,12 @@
 #include "utils.hxx"
 #include "eigenvalues.hxx"
 #include "fluxes.hxx"
+#include "activity.hxx"
+#include "covered.hxx"
+#include "timers.hxx"
 #include <reconstruct.hxx>
 #include <eos.hxx>
-#include <eos_idealgas.hxx>
+#include <eos_dispatch.hxx>
 
 namespace AsterX {
 using namespace std;
@@ -24,7 +27,6 @@ using namespace EOSX;
 using namespace ReconX;
 
 enum class flux_t { LxF, HLLE };
-enum class eos_t { IdealGas, Hybrid, Tabulated };
 enum class rec_var_t { v_vec, z_vec, s_vec };
 
 // Calculate the fluxes in direction `dir`. This function is more
@@ -34,6 +36,9 @@ template <int dir, typename EOSType>
 void CalcFlux(CCTK_ARGUMENTS, EOSType &eos_th) {
   DECLARE_CCTK_ARGUMENTSX_AsterX_Fluxes;
   DECLARE_CCTK_PARAMETERS;
+  static const char *const timer_names[dim] = {
+      "AsterX_Fluxes/x", "AsterX_Fluxes/y", "AsterX_Fluxes/z"};
+  const kernel_timer timer(timer_names[dir], cctkGH);
 
   /* grid functions for fluxes */
   const vec<GF3D2<CCTK_REAL>, dim> fluxdenss{fxdens, fydens, fzdens};
@@ -50,6 +55,10 @@ void CalcFlux(CCTK_ARGUMENTS, EOSType &eos_th) {
   const vec<GF3D2<const CCTK_REAL>, dim> gf_svec{svec_x, svec_y, svec_z};
   const vec<GF3D2<const CCTK_REAL>, dim> gf_Bvecs{Bvecx, Bvecy, Bvecz};
   const vec<GF3D2<const CCTK_REAL>, dim> gf_dBstags{dBx_stag, dBy_stag, dBz_stag};
+  const vec<GF3D2<const CCTK_REAL>, dim> gf_Avecs{Avec_x, Avec_y, Avec_z};
+  const vec<CCTK_REAL, dim> idx{1 / CCTK_DELTA_SPACE(0),
+                                1 / CCTK_DELTA_SPACE(1),
+                                1 / CCTK_DELTA_SPACE(2)};
   const vec<GF3D2<const CCTK_REAL>, dim> gf_beta{betax, betay, betaz};
   const smat<GF3D2<const CCTK_REAL>, dim> gf_g{gxx, gxy, gxz, gyy, gyz, gzz};
   /* grid functions for Upwind CT */
@@ -182,6 +191,9 @@ void CalcFlux(CCTK_ARGUMENTS, EOSType &eos_th) {
                                        dir,
                                        (dir==0) ? 1 : ( (dir==1) ? 2 : 0 )};
 
+  // Faces between two covered cells are set by ZeroFlux, see covered.hxx
+  const bool skip_covered = have_covered_cells(cctkGH);
+
   grid.loop_int_device<
       face_centred[0], face_centred[1],
       face_centred
@@ -189,6 +201,10 @@ void CalcFlux(CCTK_ARGUMENTS, EOSType &eos_th) {
                                      const PointDesc
                                          &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
 
+    if (skip_covered && finer_covered(p.I) != 0 &&
+        finer_covered(p.I - p.DI[dir]) != 0)
+      return;
+
     /* Reconstruct primitives from the cells on left (indice 0) and right
      * (indice 1) side of this face rc = reconstructed variables or
      * computed from reconstructed variables */
@@ -216,8 +232,9 @@ void CalcFlux(CCTK_ARGUMENTS, EOSType &eos_th) {
     }
 
     vec<CCTK_REAL, 2> press_rc{reconstruct_pt(press, p, false, true)};
-    // TODO: Correctly reconstruct Ye
-    const vec<CCTK_REAL, 2> ye_rc{ye_min, ye_max};
+    // TODO: Correctly reconstruct Ye once it is evolved; until then both
+    // faces use the same Ye as con2prim, see AsterX_Con2Prim
+    const vec<CCTK_REAL, 2> ye_rc{Ye_atmo, Ye_atmo};
 
     // TODO: currently sets negative reconstructed pressure to 0 since eps_min=0
     // for ideal gas
@@ -230,22 +247,32 @@ void CalcFlux(CCTK_ARGUMENTS, EOSType &eos_th) {
           eos_th.press_from_valid_rho_eps_ye(rho_rc(1), eps_min, ye_rc(1));
     }
 
-    const vec<CCTK_REAL, 2> eps_rc([&](int f) ARITH_INLINE {
-      return eos_th.eps_from_valid_rho_press_ye(rho_rc(f), press_rc(f),
-                                                ye_rc(f));
+    /* eps, cs2 and h from a single EOS evaluation per face. The temperature
+     * of the cell a face state is reconstructed from is the initial guess
+     * for the temperature inversion. */
+    const vec<CCTK_REAL, 2> temp_guess{temperature(p.I - p.DI[dir]),
+                                       temperature(p.I)};
+    const vec<eos_thermo, 2> thermo_rc([&](int f) ARITH_INLINE {
+      return eos_th.with_temp_guess(temp_guess(f))
+          .thermo_from_valid_rho_press_ye(rho_rc(f), press_rc(f), ye_rc(f));
     });
+    const vec<CCTK_REAL, 2> eps_rc(
+        [&](int f) ARITH_INLINE { return thermo_rc(f).eps; });
 
     const vec<CCTK_REAL, 2> rhoh_rc([&](int f) ARITH_INLINE {
       return rho_rc(f) + rho_rc(f)*eps_rc(f) + press_rc(f);
     });
 
     // Introduce reconstructed Bs
-    // Use staggered dB for i == dir
+    // Use staggered dB for i == dir, computed here from the vector potential
+    // if the staggered field is not materialized in the post-step
 
     vec<vec<CCTK_REAL, 2>, 3> Bs_rc;
     array<CCTK_REAL,2> Bs_rc_dummy; // note: can't copy array<,2> to vec<,2>, only construct
 
-    Bs_rc(dir)(0) = gf_dBstags(dir)(p.I)/sqrtg;
+    Bs_rc(dir)(0) = (fuse_curlA_con2prim ? calc_curlA(gf_Avecs, idx, p, dir, 0)
+                                         : gf_dBstags(dir)(p.I)) /
+                    sqrtg;
     Bs_rc(dir)(1) = Bs_rc(dir)(0);
 
     Bs_rc_dummy = reconstruct_pt(gf_Bvecs(dir_arr[0]), p, false, false);
@@ -357,21 +384,11 @@ void CalcFlux(CCTK_ARGUMENTS, EOSType &eos_th) {
     const vec<CCTK_REAL, 2> B_rc{Bs_rc(dir)};
     const vec<CCTK_REAL, 2> vtilde_rc{vtildes_rc(dir)};
 
-    // TODO: Compute pressure based on user-specified EOS.
-    // Currently, computing press for classical ideal gas from reconstructed
-    // vars
-
-    // Ideal gas case {
-    /* cs2 for ideal gas EOS */
-    const vec<CCTK_REAL, 2> cs2_rc([&](int f) ARITH_INLINE {
-      return eos_th.csnd_from_valid_rho_eps_ye(rho_rc(f), eps_rc(f), ye_rc(f)) *
-             eos_th.csnd_from_valid_rho_eps_ye(rho_rc(f), eps_rc(f), ye_rc(f));
-    });
-    /* enthalpy h for ideal gas EOS */
-    const vec<CCTK_REAL, 2> h_rc([&](int f) ARITH_INLINE {
-      return 1 + eps_rc(f) + press_rc(f) / rho_rc(f);
-    });
-    // } Ideal gas case
+    /* cs2 and enthalpy h */
+    const vec<CCTK_REAL, 2> cs2_rc(
+        [&](int f) ARITH_INLINE { return thermo_rc(f).cs2; });
+    const vec<CCTK_REAL, 2> h_rc(
+        [&](int f) ARITH_INLINE { return thermo_rc(f).h; });
 
     /* Computing conservatives from primitives: */
 
@@ -581,6 +598,45 @@ void CalcFlux(CCTK_ARGUMENTS, EOSType &eos_th) {
   });
 }
 
+// Zero fluxes in direction `dir` for boxes that are not evolved, see
+// activity.hxx. The characteristic speeds are set to one so that the upwind-CT
+// electric field is well defined; it vanishes with the magnetic field. With
+// `covered_only`, only the faces between two covered cells are set, see
+// covered.hxx; the electric field there is overwritten by restriction.
+template <int dir>
+void ZeroFlux(CCTK_ARGUMENTS, const bool covered_only = false) {
+  DECLARE_CCTK_ARGUMENTSX_AsterX_Fluxes;
+
+  const vec<vec<GF3D2<CCTK_REAL>, dim>, 8> fluxes{
+      {fxdens, fydens, fzdens}, {fxmomx, fymomx, fzmomx},
+      {fxmomy, fymomy, fzmomy}, {fxmomz, fymomz, fzmomz},
+      {fxtau, fytau, fztau},    {fxBx, fyBx, fzBx},
+      {fxBy, fyBy, fzBy},       {fxBz, fyBz, fzBz}};
+  const vec<GF3D2<CCTK_REAL>, dim> vtildes_one{vtilde_y_xface, vtilde_z_yface,
+                                               vtilde_x_zface};
+  const vec<GF3D2<CCTK_REAL>, dim> vtildes_two{vtilde_z_xface, vtilde_x_yface,
+                                               vtilde_y_zface};
+  const vec<GF3D2<CCTK_REAL>, dim> amax{amax_xface, amax_yface, amax_zface};
+  const vec<GF3D2<CCTK_REAL>, dim> amin{amin_xface, amin_yface, amin_zface};
+
+  constexpr array<int, dim> face_centred = {!(dir == 0), !(dir == 1),
+                                            !(dir == 2)};
+
+  grid.loop_int_device<face_centred[0], face_centred[1], face_centred[2]>(
+      grid.nghostzones,
+      [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+        if (covered_only && (finer_covered(p.I) == 0 ||
+                             finer_covered(p.I - p.DI[dir]) == 0))
+          return;
+        for (int n = 0; n < 8; ++n)
+          fluxes(n)(dir)(p.I) = 0;
+        vtildes_one(dir)(p.I) = 0;
+        vtildes_two(dir)(p.I) = 0;
+        amax(dir)(p.I) = 1;
+        amin(dir)(p.I) = 1;
+      });
+}
+
 void CalcAuxForAvecPsi(CCTK_ARGUMENTS) {
   DECLARE_CCTK_ARGUMENTSX_AsterX_Fluxes;
   DECLARE_CCTK_PARAMETERS;
@@ -604,53 +660,88 @@ void CalcAuxForAvecPsi(CCTK_ARGUMENTS) {
         Fx(p.I) = alp(p.I) * sqrtg * Aup(0);
         Fy(p.I) = alp(p.I) * sqrtg * Aup(1);
         Fz(p.I) = alp(p.I) * sqrtg * Aup(2);
-        Fbetax(p.I) = betas(0) * Psi(p.I);
-        Fbetay(p.I) = betas(1) * Psi(p.I);
-        Fbetaz(p.I) = betas(2) * Psi(p.I);
         G(p.I) = alp(p.I) * Psi(p.I) / sqrtg - calc_contraction(betas, A_vert);
       });
 }
 
-extern "C" void AsterX_Fluxes(CCTK_ARGUMENTS) {
-  DECLARE_CCTK_ARGUMENTS_AsterX_Fluxes;
-  DECLARE_CCTK_PARAMETERS;
+// Fluxes of a box that is not evolved, see activity.hxx
+void ZeroFluxes(CCTK_ARGUMENTS) {
+  ZeroFlux<0>(cctkGH);
+  ZeroFlux<1>(cctkGH);
+  ZeroFlux<2>(cctkGH);
+  CalcAuxForAvecPsi(cctkGH);
+}
 
-  eos_t eostype;
-  eos::range rgeps(eps_min, eps_max), rgrho(rho_min, rho_max),
-      rgye(ye_min, ye_max);
+template <typename EOSType>
+void CalcFluxes_typeEoS(CCTK_ARGUMENTS, EOSType &eos_th) {
+  DECLARE_CCTK_PARAMETERS;
 
-  if (CCTK_EQUALS(evolution_eos, "IdealGas")) {
-    eostype = eos_t::IdealGas;
-  } else if (CCTK_EQUALS(evolution_eos, "Hybrid")) {
-    eostype = eos_t::Hybrid;
-  } else if (CCTK_EQUALS(evolution_eos, "Tabulated")) {
-    eostype = eos_t::Tabulated;
-  } else {
-    CCTK_ERROR("Unknown value for parameter \"evolution_eos\"");
+  if (have_covered_cells(cctkGH)) {
+    ZeroFlux<0>(cctkGH, true);
+    ZeroFlux<1>(cctkGH, true);
+    ZeroFlux<2>(cctkGH, true);
   }
 
-  switch (eostype) {
-  case eos_t::IdealGas: {
-    eos_idealgas eos_th(gl_gamma, particle_mass, rgeps, rgrho, rgye);
+  ASTERX_KERNEL_TASKGROUP
+  {
+    ASTERX_KERNEL_TASK(concurrent_kernels)
     CalcFlux<0>(cctkGH, eos_th);
+    ASTERX_KERNEL_TASK(concurrent_kernels)
     CalcFlux<1>(cctkGH, eos_th);
+    ASTERX_KERNEL_TASK(concurrent_kernels)
     CalcFlux<2>(cctkGH, eos_th);
-    break;
+    /* Set auxiliary variables for the rhs of A and Psi  */
+    ASTERX_KERNEL_TASK(concurrent_kernels)
+    CalcAuxForAvecPsi(cctkGH);
   }
-  case eos_t::Hybrid: {
-    CCTK_ERROR("Hybrid EOS is not yet supported");
-    break;
+}
+
+void CalcFluxes(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS_AsterX_Fluxes;
+
+  if (!box_is_active(cctkGH)) {
+    ZeroFluxes(cctkGH);
+    return;
   }
-  case eos_t::Tabulated: {
-    CCTK_ERROR("Tabulated EOS is not yet supported");
-    break;
+  dispatch_eos_3p(
+      [&](const auto &eos_th) { CalcFluxes_typeEoS(cctkGH, eos_th); });
+}
+
+void CalcFluxesBenchmark(CCTK_ARGUMENTS, const int dir) {
+  DECLARE_CCTK_ARGUMENTS_AsterX_Fluxes;
+
+  if (dir < 0) {
+    CalcFluxes(cctkGH);
+    return;
   }
-  default:
-    assert(0);
+  dispatch_eos_3p([&](const auto &eos_th) {
+    switch (dir) {
+    case 0:
+      CalcFlux<0>(cctkGH, eos_th);
+      break;
+    case 1:
+      CalcFlux<1>(cctkGH, eos_th);
+      break;
+    case 2:
+      CalcFlux<2>(cctkGH, eos_th);
+      break;
+    default:
+      assert(0);
+    }
+  });
+}
+
+extern "C" void AsterX_Fluxes(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS_AsterX_Fluxes;
+
+  /* Boxes that are not evolved only zero their fluxes and are not timed */
+  if (!box_is_active(cctkGH)) {
+    ZeroFluxes(cctkGH);
+    return;
   }
+  const kernel_timer timer("AsterX_Fluxes", cctkGH, true);
 
-  /* Set auxiliary variables for the rhs of A and Psi  */
-  CalcAuxForAvecPsi(cctkGH);
+  CalcFluxes(cctkGH);
 }
 
 } // namespace AsterX
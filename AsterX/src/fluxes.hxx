@@ -48,6 +48,11 @@ hlle(vec<vec<CCTK_REAL, 4>, 2> lam, vec<CCTK_REAL, 2> var,
          charpm;
 }
 
+// Fluxes on all faces in direction dir, or in all directions together with
+// the auxiliary variables for the RHS of A and Psi if dir < 0. Used by
+// AsterX_Benchmark.
+void CalcFluxesBenchmark(CCTK_ARGUMENTS, int dir);
+
 } // namespace AsterX
 
 #endif // ASTERX_FLUXES_HXX
@@ -0,0 +1,228 @@
+#include <cctk.h>
+#include <cctk_Parameters.h>
+
+#include <map>
+#include <string>
+
+#include "kernel_model.hxx"
+
+namespace AsterX {
+using namespace std;
+
+namespace {
+
+constexpr CCTK_REAL bytes_per_gf = sizeof(CCTK_REAL);
+
+/* Metric quantities on vertices: alp, beta^i and g_ij */
+constexpr int metric_gfs = 10;
+
+/* Typical number of iterations of the primary con2prim scheme and of the
+ * temperature inversion of a tabulated EOS */
+constexpr int c2p_iterations = 8;
+constexpr int temp_iterations = 10;
+
+/* flops to reconstruct both states of one variable at one face */
+CCTK_REAL reconstruction_flops() {
+  DECLARE_CCTK_PARAMETERS;
+  if (CCTK_EQUALS(reconstruction_method, "Godunov"))
+    return 0;
+  if (CCTK_EQUALS(reconstruction_method, "minmod"))
+    return 12;
+  if (CCTK_EQUALS(reconstruction_method, "monocentral"))
+    return 20;
+  if (CCTK_EQUALS(reconstruction_method, "ppm"))
+    return ppm_shock_detection || ppm_zone_flattening ? 90 : 60;
+  if (CCTK_EQUALS(reconstruction_method, "eppm"))
+    return 110;
+  if (CCTK_EQUALS(reconstruction_method, "wenoz"))
+    return 130;
+  if (CCTK_EQUALS(reconstruction_method, "mp5"))
+    return 120;
+  CCTK_ERROR("Unknown value for parameter \"reconstruction_method\"");
+}
+
+/* flops of one pressure or eps evaluation of the evolution EOS */
+CCTK_REAL eos_call_flops() {
+  DECLARE_CCTK_PARAMETERS;
+  if (CCTK_EQUALS(evolution_eos, "IdealGas"))
+    return 5;
+  if (CCTK_EQUALS(evolution_eos, "Hybrid"))
+    return 20;
+  // trilinear interpolation in log space
+  return 60;
+}
+
+/* flops of eps, cs2 and h from rho, press and Ye */
+CCTK_REAL eos_thermo_flops() {
+  DECLARE_CCTK_PARAMETERS;
+  if (CCTK_EQUALS(evolution_eos, "Tabulated"))
+    return temp_iterations * eos_call_flops();
+  return 3 * eos_call_flops();
+}
+
+/* flops of the curl of A at one point */
+constexpr CCTK_REAL curlA_flops = 5;
+
+/* One direction of AsterX_Fluxes, per face */
+kernel_cost_t flux_dir_cost() {
+  DECLARE_CCTK_PARAMETERS;
+  const bool ppm = CCTK_EQUALS(reconstruction_method, "ppm") ||
+                   CCTK_EQUALS(reconstruction_method, "eppm");
+
+  /* rho, press, temperature, the two transverse B components and the
+   * reconstructed velocity vector; the normal B component from the staggered
+   * field or from two components of A. PPM also reads the normal velocity. */
+  int reads = metric_gfs + 6 + (fuse_curlA_con2prim ? 2 : 1);
+  if (ppm && !CCTK_EQUALS(recon_type, "v_vec"))
+    ++reads;
+  /* the eight fluxes; vtilde, amax and amin for UCT */
+  const int writes = 8 + (use_uct ? 4 : 0);
+
+  /* 7 reconstructed variables */
+  CCTK_REAL flops = 7 * reconstruction_flops();
+  /* metric averages to the face, determinant */
+  flops += metric_gfs * 4 + 15;
+  /* EOS of both states */
+  flops += 2 * eos_thermo_flops();
+  /* velocities, Lorentz factor, b^mu and b^2 of both states */
+  flops += 2 * 90;
+  /* characteristic speeds of both states */
+  flops += 2 * 40;
+  /* physical fluxes of both states and the Riemann solver */
+  flops += 8 * (2 * 8 + (CCTK_EQUALS(flux_type, "HLLE") ? 8 : 5));
+  if (fuse_curlA_con2prim)
+    flops += curlA_flops;
+  if (use_uct)
+    flops += 20;
+
+  return {reads * bytes_per_gf, writes * bytes_per_gf, flops};
+}
+
+/* CalcAuxForAvecPsi, per vertex */
+kernel_cost_t flux_aux_cost() {
+  /* A, Psi and the metric; Fx, Fy, Fz and G */
+  return {(metric_gfs + 4) * bytes_per_gf, 4 * bytes_per_gf, 80};
+}
+
+kernel_cost_t fluxes_cost() {
+  const kernel_cost_t dir = flux_dir_cost();
+  const kernel_cost_t aux = flux_aux_cost();
+  return {3 * dir.bytes_read + aux.bytes_read,
+          3 * dir.bytes_written + aux.bytes_written,
+          3 * dir.flops + aux.flops};
+}
+
+kernel_cost_t rhs_hydro_cost() {
+  /* the five conserved variables: three fluxes each, and the RHS that is
+   * updated in place */
+  return {(5 * 3 + 5) * bytes_per_gf, 5 * bytes_per_gf, 5 * 8};
+}
+
+kernel_cost_t rhs_potential_cost() {
+  DECLARE_CCTK_PARAMETERS;
+  const bool lorentz = CCTK_EQUALS(vector_potential_gauge,
+                                   "generalized Lorentz");
+
+  int reads, writes = 4;
+  CCTK_REAL flops;
+  if (use_uct) {
+    /* dBstag, vtilde, amax and amin; four reconstructions per component */
+    reads = 3 + 6 + 3 + 3;
+    flops = 3 * (4 * reconstruction_flops() + 25);
+  } else {
+    /* the fluxes of the transverse B components */
+    reads = 6;
+    flops = 3 * 5;
+  }
+  if (lorentz) {
+    /* G for A; F^i, beta^i, alp and Psi for Psi */
+    reads += 1 + 3 + 3 + 2;
+    flops += 3 * 3 + 3 * 12 + 4;
+  }
+  return {reads * bytes_per_gf, writes * bytes_per_gf, flops};
+}
+
+kernel_cost_t rhs_cost() {
+  const kernel_cost_t hydro = rhs_hydro_cost();
+  const kernel_cost_t potential = rhs_potential_cost();
+  return {hydro.bytes_read + potential.bytes_read,
+          hydro.bytes_written + potential.bytes_written,
+          hydro.flops + potential.flops};
+}
+
+kernel_cost_t source_cost() {
+  DECLARE_CCTK_PARAMETERS;
+  /* the metric and extrinsic curvature, rho, eps, press, velocity and B */
+  const int reads = metric_gfs + 6 + 9;
+  const int writes = 5;
+  /* averages to the centre, derivatives of alp, beta^i and g_ij along three
+   * directions, inverse metric and T^munu contractions */
+  CCTK_REAL flops = (metric_gfs + 6) * 9;
+  flops += 10 * 3 * (local_spatial_order == 4 ? 24 : 12);
+  flops += 40 + 300;
+  return {reads * bytes_per_gf, writes * bytes_per_gf, flops};
+}
+
+kernel_cost_t con2prim_cost() {
+  DECLARE_CCTK_PARAMETERS;
+  /* conserved variables, the centred or curl of the staggered B, saved
+   * primitives and the metric */
+  const int reads = 5 + 3 + 5 + 6;
+  /* conserved variables and B, primitives, temperature, zvec, svec, saved
+   * primitives and the flag */
+  const int writes = 5 + 3 + 9 + 1 + 3 + 3 + 5 + 1;
+
+  /* metric average and inverse, atmosphere */
+  CCTK_REAL flops = 6 * 9 + 40 + 30;
+  if (fuse_curlA_con2prim)
+    flops += 3 * 4 * curlA_flops;
+  /* root finding, one EOS evaluation per iteration */
+  const CCTK_REAL iteration_flops =
+      CCTK_EQUALS(c2p_prime, "Noble") ? 120 : 60;
+  flops += c2p_iterations * (iteration_flops + eos_call_flops());
+  /* prim2con check, temperature, zvec, svec */
+  flops += 100 + eos_thermo_flops() + 20;
+  return {reads * bytes_per_gf, writes * bytes_per_gf, flops};
+}
+
+kernel_cost_t tmunu_cost() {
+  DECLARE_CCTK_PARAMETERS;
+  /* rho, eps, press, velocity and B interpolated to vertices, the metric,
+   * and T_munu which is updated in place */
+  const int reads = 9 + metric_gfs + 10;
+  const int writes = 10;
+  const int stencil = tmunu_interp_order == 4 ? 64 : 8;
+  return {reads * bytes_per_gf, writes * bytes_per_gf,
+          9 * CCTK_REAL(stencil + 1) + 200};
+}
+
+kernel_cost_t curlA_cost() {
+  return {3 * bytes_per_gf, 3 * bytes_per_gf, 3 * curlA_flops};
+}
+
+/* Routines with a model, by the name of their timer. Sub-timers of a routine
+ * are named "<routine>/<part>". */
+const map<string, kernel_cost_t (*)()> kernel_models = {
+    {"AsterX_ComputedBstagFromA", curlA_cost},
+    {"AsterX_Con2Prim", con2prim_cost},
+    {"AsterX_Fluxes", fluxes_cost},
+    {"AsterX_Fluxes/x", flux_dir_cost},
+    {"AsterX_Fluxes/y", flux_dir_cost},
+    {"AsterX_Fluxes/z", flux_dir_cost},
+    {"AsterX_RHS", rhs_cost},
+    {"AsterX_RHS_Potential", rhs_potential_cost},
+    {"AsterX_SourceTerms", source_cost},
+    {"AsterX_Tmunu", tmunu_cost},
+};
+
+} // namespace
+
+bool kernel_cost(const string &routine, kernel_cost_t &cost) {
+  const auto it = kernel_models.find(routine);
+  if (it == kernel_models.end())
+    return false;
+  cost = it->second();
+  return true;
+}
+
+} // namespace AsterX
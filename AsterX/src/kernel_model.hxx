@@ -0,0 +1,38 @@
+#ifndef ASTERX_KERNEL_MODEL_HXX
+#define ASTERX_KERNEL_MODEL_HXX
+
+#include <cctk.h>
+
+#include <string>
+
+namespace AsterX {
+
+/* Analytic cost of a timed routine per interior cell, for placing it on a
+ * roofline together with the measured timers.
+ *
+ * bytes_read and bytes_written count every grid function the kernels access
+ * once per cell, i.e. the compulsory memory traffic if the neighbours of a
+ * stencil are reused from cache. The actual traffic is higher for kernels
+ * with wide stencils on large boxes.
+ *
+ * flops are approximate: additions, multiplications, divisions, square roots
+ * and powers count as one each, and iterative parts (con2prim, temperature
+ * inversions of tabulated EOSs) assume a typical number of iterations.
+ *
+ * The cost depends on the current values of the reconstruction, flux, UCT,
+ * gauge, EOS and con2prim parameters. */
+struct kernel_cost_t {
+  CCTK_REAL bytes_read = 0;
+  CCTK_REAL bytes_written = 0;
+  CCTK_REAL flops = 0;
+
+  CCTK_REAL bytes() const { return bytes_read + bytes_written; }
+};
+
+/* The cost of a routine as named by its kernel_timer. Returns false if no
+ * model is registered for it. */
+bool kernel_cost(const std::string &routine, kernel_cost_t &cost);
+
+} // namespace AsterX
+
+#endif // #ifndef ASTERX_KERNEL_MODEL_HXX
@@ -0,0 +1,284 @@
+#include <loop_device.hxx>
+
+#include <cctk.h>
+#include <cctk_Arguments.h>
+#include <cctk_Parameters.h>
+#include <util_Table.h>
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "box_utils.hxx"
+#include "estimate_error.hxx"
+
+namespace AsterX {
+using namespace std;
+
+namespace {
+
+/* size of the parameter array memory_plan_cells */
+constexpr int max_plan_levels = 30;
+
+/* What a grid function group is used for. Evolved groups and their RHS are
+ * also copied by the time integrator; temporary groups are recomputed every
+ * step and not checkpointed; unused groups are allocated but not read or
+ * written with the current parameters. */
+enum class group_kind_t { evolved, rhs, stored, temporary, unused };
+
+const char *group_kind_name(const group_kind_t kind) {
+  switch (kind) {
+  case group_kind_t::evolved:
+    return "evolved";
+  case group_kind_t::rhs:
+    return "rhs";
+  case group_kind_t::stored:
+    return "stored";
+  case group_kind_t::temporary:
+    return "temporary";
+  case group_kind_t::unused:
+    return "unused";
+  }
+  return "";
+}
+
+string tag_string(const int gi, const char *key) {
+  const int tags = CCTK_GroupTagsTableI(gi);
+  if (tags < 0)
+    return "";
+  char value[1000];
+  if (Util_TableGetString(tags, sizeof value, value, key) < 0)
+    return "";
+  return value;
+}
+
+/* AsterX groups that the current parameters leave unused */
+bool group_is_unused(const int gi) {
+  DECLARE_CCTK_PARAMETERS;
+
+  set<int> unused;
+  const auto add = [&](const char *name) {
+    const int gj = CCTK_GroupIndex(name);
+    if (gj >= 0)
+      unused.insert(gj);
+  };
+  /* never set */
+  add("AsterX::Bx_stag");
+  add("AsterX::By_stag");
+  add("AsterX::Bz_stag");
+  if (!use_uct) {
+    for (const char *name :
+         {"AsterX::vtilde_xface", "AsterX::vtilde_yface",
+          "AsterX::vtilde_zface", "AsterX::a_xface", "AsterX::a_yface",
+          "AsterX::a_zface"})
+      add(name);
+    if (fuse_curlA_con2prim)
+      for (const char *name :
+           {"AsterX::dBx_stag", "AsterX::dBy_stag", "AsterX::dBz_stag"})
+        add(name);
+  }
+  return unused.count(gi);
+}
+
+/* The kind of every group, from its "rhs" and "checkpoint" tags */
+map<int, group_kind_t> group_kinds() {
+  set<int> rhs_groups;
+  for (int gi = 0; gi < CCTK_NumGroups(); ++gi) {
+    const string rhs = tag_string(gi, "rhs");
+    if (rhs.empty())
+      continue;
+    const string name =
+        rhs.find("::") == string::npos
+            ? string(CCTK_GroupImplementationI(gi)) + "::" + rhs
+            : rhs;
+    const int gj = CCTK_GroupIndex(name.c_str());
+    if (gj >= 0)
+      rhs_groups.insert(gj);
+  }
+
+  map<int, group_kind_t> kinds;
+  for (int gi = 0; gi < CCTK_NumGroups(); ++gi) {
+    if (group_is_unused(gi))
+      kinds[gi] = group_kind_t::unused;
+    else if (!tag_string(gi, "rhs").empty())
+      kinds[gi] = group_kind_t::evolved;
+    else if (rhs_groups.count(gi))
+      kinds[gi] = group_kind_t::rhs;
+    else if (CCTK_EQUALS(tag_string(gi, "checkpoint").c_str(), "no"))
+      kinds[gi] = group_kind_t::temporary;
+    else
+      kinds[gi] = group_kind_t::stored;
+  }
+  return kinds;
+}
+
+/* Grid function groups of the implementations listed in
+ * memory_report_implementations */
+bool group_is_reported(const int gi) {
+  DECLARE_CCTK_PARAMETERS;
+
+  if (CCTK_GroupTypeI(gi) != CCTK_GF)
+    return false;
+  if (CCTK_EQUALS(memory_report_implementations, "all"))
+    return true;
+  istringstream implementations(memory_report_implementations);
+  string implementation;
+  while (implementations >> implementation)
+    if (CCTK_EQUALS(implementation.c_str(), CCTK_GroupImplementationI(gi)))
+      return true;
+  return false;
+}
+
+/* bytes per grid point of a group, over all its variables and timelevels */
+CCTK_REAL group_point_bytes(const cGH *cctkGH, const int gi) {
+  cGroup data;
+  CCTK_GroupData(gi, &data);
+  const int timelevels = max(CCTK_ActiveTimeLevelsGI(cctkGH, gi), 1);
+  return CCTK_REAL(data.numvars) * timelevels * CCTK_VarTypeSize(data.vartype);
+}
+
+struct group_memory_t {
+  int boxes = 0;
+  CCTK_REAL bytes = 0;
+  CCTK_REAL interior_bytes = 0;
+};
+
+/* memory of the local boxes, by level and group, since the last report */
+mutex memory_report_mutex;
+map<pair<int, int>, group_memory_t> memory_report;
+
+void memory_plan(const cGH *cctkGH) {
+  DECLARE_CCTK_PARAMETERS;
+
+  const int nprocs =
+      memory_plan_processes > 0 ? memory_plan_processes : CCTK_nProcs(cctkGH);
+  /* ghost zones of a typical box */
+  CCTK_REAL ghost_factor = 1;
+  for (int d = 0; d < Loop::dim; ++d)
+    ghost_factor *= CCTK_REAL(memory_plan_box_size +
+                              2 * cctkGH->cctk_nghostzones[d]) /
+                    memory_plan_box_size;
+
+  CCTK_REAL cell_bytes = 0;
+  for (int gi = 0; gi < CCTK_NumGroups(); ++gi)
+    if (group_is_reported(gi))
+      cell_bytes += group_point_bytes(cctkGH, gi);
+
+  CCTK_VINFO("Memory plan for %d processes with boxes of %d^3 cells "
+             "(%.0f bytes per cell, ghost zone factor %.3f):",
+             nprocs, int(memory_plan_box_size), double(cell_bytes),
+             double(ghost_factor));
+  CCTK_REAL total = 0;
+  for (int level = 0; level < max_plan_levels; ++level) {
+    if (memory_plan_cells[level] <= 0)
+      continue;
+    const CCTK_REAL bytes =
+        memory_plan_cells[level] / nprocs * ghost_factor * cell_bytes;
+    CCTK_VINFO("  level %2d  %16.0f cells  %12.3f MB per process", level,
+               double(memory_plan_cells[level]), double(bytes / 1.0e6));
+    total += bytes;
+  }
+  CCTK_VINFO("  total                             %12.3f MB per process",
+             double(total / 1.0e6));
+  if (memory_plan_budget > 0 && total > memory_plan_budget)
+    CCTK_VWARN(CCTK_WARN_ALERT,
+               "The planned grid needs %.3f MB per process for grid "
+               "functions, more than memory_plan_budget = %.3f MB",
+               double(total / 1.0e6), double(memory_plan_budget / 1.0e6));
+}
+
+} // namespace
+
+extern "C" void AsterX_MemoryReport_Count(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS;
+
+  const int level = refinement_level(cctkGH);
+
+  map<int, group_memory_t> box_memory;
+  for (int gi = 0; gi < CCTK_NumGroups(); ++gi) {
+    if (!group_is_reported(gi))
+      continue;
+    const auto indextype = get_group_indextype(gi);
+    CCTK_REAL npoints_all = 1, npoints_interior = 1;
+    for (int d = 0; d < Loop::dim; ++d) {
+      const int npoints = cctk_lsh[d] - indextype[d];
+      npoints_all *= npoints;
+      npoints_interior *= npoints - 2 * cctk_nghostzones[d];
+    }
+    const CCTK_REAL point_bytes = group_point_bytes(cctkGH, gi);
+    auto &memory = box_memory[gi];
+    memory.boxes = 1;
+    memory.bytes = npoints_all * point_bytes;
+    memory.interior_bytes = npoints_interior * point_bytes;
+  }
+
+  const lock_guard<mutex> lock(memory_report_mutex);
+  for (const auto &[gi, memory] : box_memory) {
+    auto &total = memory_report[{level, gi}];
+    total.boxes += memory.boxes;
+    total.bytes += memory.bytes;
+    total.interior_bytes += memory.interior_bytes;
+  }
+}
+
+extern "C" void AsterX_MemoryReport_Output(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS;
+  DECLARE_CCTK_PARAMETERS;
+
+  const lock_guard<mutex> lock(memory_report_mutex);
+  if (memory_report.empty())
+    return;
+  const auto kinds = group_kinds();
+
+  CCTK_VINFO("Grid function memory on process %d (iteration %d), including "
+             "ghost zones and timelevels:",
+             CCTK_MyProc(cctkGH), cctk_iteration);
+  CCTK_VINFO("  %5s  %-32s %-9s %4s %3s %6s %12s %7s", "level", "group",
+             "kind", "vars", "tl", "boxes", "MB", "ghosts");
+  map<int, CCTK_REAL> level_totals;
+  map<group_kind_t, CCTK_REAL> kind_totals;
+  for (const auto &[key, memory] : memory_report) {
+    const auto [level, gi] = key;
+    const group_kind_t kind = kinds.at(gi);
+    char *const name = CCTK_FullGroupName(gi);
+    CCTK_VINFO("  %5d  %-32s %-9s %4d %3d %6d %12.3f %6.1f%%", level, name,
+               group_kind_name(kind), CCTK_NumVarsInGroupI(gi),
+               max(CCTK_ActiveTimeLevelsGI(cctkGH, gi), 1), memory.boxes,
+               double(memory.bytes / 1.0e6),
+               double(100 * (1 - memory.interior_bytes /
+                                     max(memory.bytes, CCTK_REAL(1)))));
+    free(name);
+    level_totals[level] += memory.bytes;
+    kind_totals[kind] += memory.bytes;
+  }
+
+  CCTK_REAL total = 0;
+  for (const auto &[level, bytes] : level_totals) {
+    CCTK_VINFO("  level %d total: %.3f MB", level, double(bytes / 1.0e6));
+    total += bytes;
+  }
+  for (const auto &[kind, bytes] : kind_totals)
+    CCTK_VINFO("  %s total: %.3f MB", group_kind_name(kind),
+               double(bytes / 1.0e6));
+  CCTK_VINFO("  total: %.3f MB (evolved and rhs groups are also copied by "
+             "the time integrator)",
+             double(total / 1.0e6));
+  memory_report.clear();
+
+  /* The plan does not depend on the current grid */
+  static bool planned = false;
+  bool have_plan = false;
+  for (int level = 0; level < max_plan_levels; ++level)
+    have_plan |= memory_plan_cells[level] > 0;
+  if (have_plan && !planned)
+    memory_plan(cctkGH);
+  planned = true;
+}
+
+} // namespace AsterX
@@ -0,0 +1,27 @@
+#include <cctk.h>
+#include <cctk_Arguments.h>
+#include <cctk_Parameters.h>
+
+namespace AsterX {
+
+extern "C" void AsterX_ParamCheck(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS_AsterX_ParamCheck;
+  DECLARE_CCTK_PARAMETERS;
+
+  /* The Noble solver assumes an ideal gas, see c2p_2DNoble.hxx */
+  if (!CCTK_EQUALS(evolution_eos, "IdealGas") &&
+      (CCTK_EQUALS(c2p_prime, "Noble") || CCTK_EQUALS(c2p_second, "Noble")))
+    CCTK_VPARAMWARN("The Noble con2prim solver requires an ideal gas EOS; "
+                    "use c2p_prime = c2p_second = \"Palenzuela\" with "
+                    "evolution_eos = \"%s\"",
+                    evolution_eos);
+
+  /* Ye is not evolved, all EOS calls use Ye_atmo */
+  if (Ye_atmo < ye_min || Ye_atmo > ye_max)
+    CCTK_VPARAMWARN("Con2PrimFactory::Ye_atmo = %g, which AsterX uses as the "
+                    "electron fraction everywhere, lies outside the EOS range "
+                    "[%g, %g]",
+                    double(Ye_atmo), double(ye_min), double(ye_max));
+}
+
+} // namespace AsterX
@@ -50,6 +50,7 @@ extern "C" void AsterX_Prim2Con_Initial(CCTK_ARGUMENTS) {
         saved_vely(p.I) = pv.vel(1);
         saved_velz(p.I) = pv.vel(2);
         saved_eps(p.I) = pv.eps;
+        saved_temperature(p.I) = temperature(p.I);
 
 	const vec<CCTK_REAL, 3> v_up{pv.vel(0),pv.vel(1),pv.vel(2)};
         const vec<CCTK_REAL, 3> v_low = calc_contraction(g, v_up);
@@ -6,6 +6,9 @@
 
 #include <reconstruct.hxx>
 #include "utils.hxx"
+#include "activity.hxx"
+#include "covered.hxx"
+#include "timers.hxx"
 
 // #ifdef AMREX_USE_GPU
 // #include <AMReX_GpuDevice.H>
@@ -23,6 +26,10 @@ enum class vector_potential_gauge_t { algebraic, generalized_lorentz };
 extern "C" void AsterX_RHS(CCTK_ARGUMENTS) {
   DECLARE_CCTK_ARGUMENTSX_AsterX_RHS;
   DECLARE_CCTK_PARAMETERS;
+  /* Boxes that are not evolved only update the vector potential */
+  const kernel_timer timer(
+      box_is_active(cctkGH) ? "AsterX_RHS" : "AsterX_RHS_Potential", cctkGH,
+      true);
 
   reconstruction_t reconstruction;
   if (CCTK_EQUALS(reconstruction_method, "Godunov"))
@@ -84,7 +91,6 @@ extern "C" void AsterX_RHS(CCTK_ARGUMENTS) {
       {fxBx, fyBx, fzBx}, {fxBy, fyBy, fzBy}, {fxBz, fyBz, fzBz}};
   const vec<GF3D2<const CCTK_REAL>, dim> gf_F{Fx, Fy, Fz};
   const vec<GF3D2<const CCTK_REAL>, dim> gf_beta{betax, betay, betaz};
-  const vec<GF3D2<const CCTK_REAL>, dim> gf_Fbeta{Fbetax, Fbetay, Fbetaz};
   /* grid functions for Upwind CT */
   const vec<GF3D2<const CCTK_REAL>, dim> gf_vels{velx, vely, velz};
   const vec<GF3D2<const CCTK_REAL>, dim> dBstag_one{dBy_stag, dBz_stag,
@@ -188,70 +194,90 @@ extern "C" void AsterX_RHS(CCTK_ARGUMENTS) {
     }
   };
 
-  grid.loop_int_device<1, 1, 1>(
-      grid.nghostzones,
-      [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
-        densrhs(p.I) += calcupdate_hydro(gf_fdens, p);
-        momxrhs(p.I) += calcupdate_hydro(gf_fmomx, p);
-        momyrhs(p.I) += calcupdate_hydro(gf_fmomy, p);
-        momzrhs(p.I) += calcupdate_hydro(gf_fmomz, p);
-        taurhs(p.I) += calcupdate_hydro(gf_ftau, p);
-        
-        if (isnan(densrhs(p.I))) {
-          printf("calcupdate = %f, ", calcupdate_hydro(gf_fdens, p));
-          printf("densrhs = %f, gf_fdens = %f, %f, %f, %f, %f, %f \n",
-                 densrhs(p.I), gf_fdens(0)(p.I), gf_fdens(1)(p.I),
-                 gf_fdens(2)(p.I), gf_fdens(0)(p.I + p.DI[0]),
-                 gf_fdens(1)(p.I + p.DI[1]), gf_fdens(2)(p.I + p.DI[2]));
-        }
-        assert(!isnan(densrhs(p.I)));
-        
-      });
+  /* The hydro update and the updates of the vector potential components and
+   * Psi are independent of each other */
+  ASTERX_KERNEL_TASKGROUP
+  {
+    /* The hydro RHS of boxes that are not evolved stays zero */
+    if (box_is_active(cctkGH)) {
+      /* and neither does the hydro RHS of covered cells, see covered.hxx */
+      const bool skip_covered = have_covered_cells(cctkGH);
+      ASTERX_KERNEL_TASK(concurrent_kernels)
+      grid.loop_int_device<1, 1, 1>(
+          grid.nghostzones,
+          [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+            if (skip_covered && finer_covered(p.I) != 0)
+              return;
+            densrhs(p.I) += calcupdate_hydro(gf_fdens, p);
+            momxrhs(p.I) += calcupdate_hydro(gf_fmomx, p);
+            momyrhs(p.I) += calcupdate_hydro(gf_fmomy, p);
+            momzrhs(p.I) += calcupdate_hydro(gf_fmomz, p);
+            taurhs(p.I) += calcupdate_hydro(gf_ftau, p);
+
+            if (isnan(densrhs(p.I))) {
+              printf("calcupdate = %f, ", calcupdate_hydro(gf_fdens, p));
+              printf("densrhs = %f, gf_fdens = %f, %f, %f, %f, %f, %f \n",
+                     densrhs(p.I), gf_fdens(0)(p.I), gf_fdens(1)(p.I),
+                     gf_fdens(2)(p.I), gf_fdens(0)(p.I + p.DI[0]),
+                     gf_fdens(1)(p.I + p.DI[1]), gf_fdens(2)(p.I + p.DI[2]));
+            }
+            assert(!isnan(densrhs(p.I)));
+
+          });
+    }
 
-  grid.loop_int_device<1, 0, 0>(grid.nghostzones,
-                                [=] CCTK_DEVICE(const PointDesc &p)
-                                    CCTK_ATTRIBUTE_ALWAYS_INLINE {
-                                      Avec_x_rhs(p.I) = calcupdate_Avec(p, 0);
-                                    });
-
-  grid.loop_int_device<0, 1, 0>(grid.nghostzones,
-                                [=] CCTK_DEVICE(const PointDesc &p)
-                                    CCTK_ATTRIBUTE_ALWAYS_INLINE {
-                                      Avec_y_rhs(p.I) = calcupdate_Avec(p, 1);
-                                    });
-
-  grid.loop_int_device<0, 0, 1>(grid.nghostzones,
-                                [=] CCTK_DEVICE(const PointDesc &p)
-                                    CCTK_ATTRIBUTE_ALWAYS_INLINE {
-                                      Avec_z_rhs(p.I) = calcupdate_Avec(p, 2);
-                                    });
-
-  grid.loop_int_device<0, 0, 0>(
-      grid.nghostzones,
-      [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
-        switch (gauge) {
-        case vector_potential_gauge_t::algebraic: {
-          Psi_rhs(p.I) = 0.0;
-          break;
-        }
-
-        case vector_potential_gauge_t::generalized_lorentz: {
-          CCTK_REAL dF = 0.0;
-          for (int i = 0; i < dim; i++) {
-            /* diFi on vertices (should be v2v but c2c works too) */
-            dF += calc_fd2_c2c(gf_F(i), p, i) -
-                  (gf_beta(i)(p.I) < 0
-                       ? calc_fd2_v2v_oneside(gf_Fbeta(i), p, i, -1)
-                       : calc_fd2_v2v_oneside(gf_Fbeta(i), p, i, 1));
-          }
-          Psi_rhs(p.I) = -dF - lorenz_damp_fac * alp(p.I) * Psi(p.I);
-          break;
-        }
-
-        default:
-          assert(0);
-        }
-      });
+    /* The vector potential and Psi are evolved in every box */
+    {
+      ASTERX_KERNEL_TASK(concurrent_kernels)
+      grid.loop_int_device<1, 0, 0>(
+          grid.nghostzones,
+          [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+            Avec_x_rhs(p.I) = calcupdate_Avec(p, 0);
+          });
+
+      ASTERX_KERNEL_TASK(concurrent_kernels)
+      grid.loop_int_device<0, 1, 0>(
+          grid.nghostzones,
+          [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+            Avec_y_rhs(p.I) = calcupdate_Avec(p, 1);
+          });
+
+      ASTERX_KERNEL_TASK(concurrent_kernels)
+      grid.loop_int_device<0, 0, 1>(
+          grid.nghostzones,
+          [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+            Avec_z_rhs(p.I) = calcupdate_Avec(p, 2);
+          });
+
+      ASTERX_KERNEL_TASK(concurrent_kernels)
+      grid.loop_int_device<0, 0, 0>(
+          grid.nghostzones,
+          [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+            switch (gauge) {
+            case vector_potential_gauge_t::algebraic: {
+              Psi_rhs(p.I) = 0.0;
+              break;
+            }
+
+            case vector_potential_gauge_t::generalized_lorentz: {
+              CCTK_REAL dF = 0.0;
+              for (int i = 0; i < dim; i++) {
+                /* diFi on vertices (should be v2v but c2c works too) */
+                /* beta^i Psi is formed on the fly instead of being stored */
+                const int sign = gf_beta(i)(p.I) < 0 ? -1 : 1;
+                dF += calc_fd2_c2c(gf_F(i), p, i) -
+                      calc_fd2_v2v_oneside_prod(gf_beta(i), Psi, p, i, sign);
+              }
+              Psi_rhs(p.I) = -dF - lorenz_damp_fac * alp(p.I) * Psi(p.I);
+              break;
+            }
+
+            default:
+              assert(0);
+            }
+          });
+    }
+  }
 }
 
 } // namespace AsterX
@@ -9,6 +9,9 @@
 #include <cassert>
 #include <cmath>
 #include "utils.hxx"
+#include "activity.hxx"
+#include "covered.hxx"
+#include "timers.hxx"
 
 namespace AsterX {
 using namespace std;
@@ -25,11 +28,22 @@ template <int FDORDER> void SourceTerms(CCTK_ARGUMENTS) {
   const vec<GF3D2<const CCTK_REAL>, 3> gf_beta{betax, betay, betaz};
   const smat<GF3D2<const CCTK_REAL>, 3> gf_g{gxx, gxy, gxz, gyy, gyz, gzz};
   const smat<GF3D2<const CCTK_REAL>, 3> gf_k{kxx, kxy, kxz, kyy, kyz, kzz};
+  const bool skip_covered = have_covered_cells(cctkGH);
 
   /* Loop over the entire grid (0 to n-1 cells in each direction) */
   grid.loop_int_device<1, 1, 1>(
       grid.nghostzones,
       [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+        /* The hydro RHS of covered cells is zero, see covered.hxx */
+        if (skip_covered && finer_covered(p.I) != 0) {
+          densrhs(p.I) = 0.0;
+          momxrhs(p.I) = 0.0;
+          momyrhs(p.I) = 0.0;
+          momzrhs(p.I) = 0.0;
+          taurhs(p.I) = 0.0;
+          return;
+        }
+
         /* Computing metric components at cell centers */
         const CCTK_REAL alp_avg = calc_avg_v2c(alp, p);
         const vec<CCTK_REAL, 3> beta_avg(
@@ -165,10 +179,31 @@ template <int FDORDER> void SourceTerms(CCTK_ARGUMENTS) {
       }); // end of loop over grid
 }
 
+/* The hydro RHS of boxes that are not evolved, see activity.hxx */
+void ZeroSourceTerms(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTSX_AsterX_SourceTerms;
+
+  grid.loop_int_device<1, 1, 1>(
+      grid.nghostzones,
+      [=] CCTK_DEVICE(const PointDesc &p) CCTK_ATTRIBUTE_ALWAYS_INLINE {
+        densrhs(p.I) = 0.0;
+        momxrhs(p.I) = 0.0;
+        momyrhs(p.I) = 0.0;
+        momzrhs(p.I) = 0.0;
+        taurhs(p.I) = 0.0;
+      });
+}
+
 extern "C" void AsterX_SourceTerms(CCTK_ARGUMENTS) {
   DECLARE_CCTK_ARGUMENTSX_AsterX_SourceTerms;
   DECLARE_CCTK_PARAMETERS;
 
+  if (!box_is_active(cctkGH)) {
+    ZeroSourceTerms(cctkGH);
+    return;
+  }
+  const kernel_timer timer("AsterX_SourceTerms", cctkGH);
+
   /* order of finite differencing */
   switch (local_spatial_order) {
   case 2:
@@ -1,15 +1,179 @@
+#include <loop_device.hxx>
+
 #include <cctk.h>
 #include <cctk_Arguments.h>
 #include <cctk_Parameters.h>
 
+#include <array>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "box_utils.hxx"
+#include "estimate_error.hxx"
+#include "timers.hxx"
+
 namespace AsterX {
+using namespace std;
 
 ////////////////////////////////////////////////////////////////////////////////
 
 extern "C" void AsterX_Sync(CCTK_ARGUMENTS) {
   DECLARE_CCTK_ARGUMENTSX_AsterX_Sync;
 
-  // do nothing
+  // do nothing but SYNC
+  trace_sync("AsterX_Sync");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/* SYNC statements of schedule.ccl for the current parameters. Keep this table
+ * in the same order as (and consistent with) the schedule; it is only used to
+ * report how many bytes the ghost zone exchanges move, it does not trigger any
+ * synchronization. Routines that run in a different place depending on
+ * fuse_curlA_con2prim are listed where they run in the current
+ * configuration. */
+struct sync_entry_t {
+  const char *bin;
+  const char *routine;
+  vector<string> groups;
+};
+
+vector<sync_entry_t> sync_entries() {
+  DECLARE_CCTK_PARAMETERS;
+
+  const vector<string> dBstag{"AsterX::dBx_stag", "AsterX::dBy_stag",
+                              "AsterX::dBz_stag"};
+  const vector<string> con2prim{
+      "AsterX::con2prim_flag", "HydroBaseX::rho", "HydroBaseX::vel",
+      "HydroBaseX::eps", "HydroBaseX::press", "HydroBaseX::Bvec",
+      "HydroBaseX::temperature", "AsterX::saved_prims", "AsterX::zvec",
+      "AsterX::svec", "AsterX::dens", "AsterX::tau", "AsterX::mom",
+      "AsterX::dB"};
+  const vector<string> fluxes{
+      "AsterX::Aux_in_RHSof_A_Psi", "AsterX::flux_x", "AsterX::flux_y",
+      "AsterX::flux_z", "AsterX::vtilde_xface", "AsterX::vtilde_yface",
+      "AsterX::vtilde_zface", "AsterX::a_xface", "AsterX::a_yface",
+      "AsterX::a_zface"};
+  const vector<string> rhs{"AsterX::densrhs",    "AsterX::taurhs",
+                           "AsterX::momrhs",     "AsterX::Avec_x_rhs",
+                           "AsterX::Avec_y_rhs", "AsterX::Avec_z_rhs",
+                           "AsterX::Psi_rhs"};
+  const vector<string> evolved{"AsterX::dens",   "AsterX::tau",
+                               "AsterX::mom",    "AsterX::Avec_x",
+                               "AsterX::Avec_y", "AsterX::Avec_z",
+                               "AsterX::Psi",    "AsterX::saved_prims"};
+
+  vector<sync_entry_t> entries{
+      {"initial", "AsterX_ComputedBstagFromA", dBstag},
+      {"initial", "AsterX_ComputeBFromdB", {"HydroBaseX::Bvec"}},
+      {"initial", "AsterX_Temperature_Initial", {"HydroBaseX::temperature"}},
+      {"initial",
+       "AsterX_Prim2Con_Initial",
+       {"AsterX::dens", "AsterX::tau", "AsterX::mom", "AsterX::dB",
+        "AsterX::saved_prims", "AsterX::zvec", "AsterX::svec"}},
+      {"postregrid", "AsterX_Sync", evolved},
+      {"recover", "AsterX_Sync", evolved},
+  };
+  /* AsterX_Con2PrimGroup runs after recovery and in every post-step */
+  const auto push_con2prim_group = [&](const char *const bin) {
+    if (!fuse_curlA_con2prim)
+      entries.push_back({bin, "AsterX_ComputedBstagFromA", dBstag});
+    entries.push_back({bin, "AsterX_Con2Prim", con2prim});
+  };
+  push_con2prim_group("recover");
+  entries.push_back(
+      {"PostStep",
+       "AsterX_Sync",
+       {"AsterX::Avec_x", "AsterX::Avec_y", "AsterX::Avec_z", "AsterX::Psi"}});
+  push_con2prim_group("PostStep");
+  if (interpolate_failed_c2p)
+    entries.push_back(
+        {"RHS",
+         "AsterX_Con2Prim_Interpolate_Failed",
+         {"AsterX::con2prim_flag", "HydroBaseX::rho", "HydroBaseX::vel",
+          "HydroBaseX::eps", "HydroBaseX::press", "AsterX::saved_prims",
+          "AsterX::dens", "AsterX::tau", "AsterX::mom"}});
+  if (fuse_curlA_con2prim && use_uct)
+    entries.push_back({"RHS", "AsterX_ComputedBstagFromA", dBstag});
+  entries.push_back({"RHS", "AsterX_Fluxes", fluxes});
+  entries.push_back({"RHS", "AsterX_RHS", rhs});
+  if (update_tmunu)
+    entries.push_back(
+        {"AddToTmunu",
+         "AsterX_Tmunu",
+         {"TmunuBaseX::eTtt", "TmunuBaseX::eTti", "TmunuBaseX::eTij"}});
+  return entries;
+}
+
+/* bytes per SYNC statement, accumulated over all local boxes of a level */
+mutex sync_report_mutex;
+map<int, vector<CCTK_REAL> > sync_report_bytes;
+
+extern "C" void AsterX_SyncReport_Count(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTSX_AsterX_SyncReport_Count;
+  DECLARE_CCTK_PARAMETERS;
+
+  if (sync_report_every <= 0 || cctk_iteration % sync_report_every != 0)
+    return;
+
+  const int level = refinement_level(cctkGH);
+
+  const auto entries = sync_entries();
+  vector<CCTK_REAL> bytes(entries.size(), 0);
+  for (size_t n = 0; n < entries.size(); ++n) {
+    for (const auto &group : entries[n].groups) {
+      const int gi = CCTK_GroupIndex(group.c_str());
+      if (gi < 0)
+        continue;
+      const auto indextype = get_group_indextype(gi);
+
+      /* Points in the ghost zones of this box that are filled by
+       * communication, i.e. excluding faces on the outer boundary */
+      CCTK_REAL npoints_all = 1, npoints_owned = 1;
+      for (int d = 0; d < Loop::dim; ++d) {
+        const int npoints = cctk_lsh[d] - indextype[d];
+        const int nghosts_lo = cctk_bbox[2 * d] ? 0 : cctk_nghostzones[d];
+        const int nghosts_hi = cctk_bbox[2 * d + 1] ? 0 : cctk_nghostzones[d];
+        npoints_all *= npoints;
+        npoints_owned *= npoints - nghosts_lo - nghosts_hi;
+      }
+      bytes[n] += (npoints_all - npoints_owned) * CCTK_NumVarsInGroupI(gi) *
+                  sizeof(CCTK_REAL);
+    }
+  }
+
+  const lock_guard<mutex> lock(sync_report_mutex);
+  auto &level_bytes = sync_report_bytes[level];
+  level_bytes.resize(entries.size(), 0);
+  for (size_t n = 0; n < entries.size(); ++n)
+    level_bytes[n] += bytes[n];
+}
+
+extern "C" void AsterX_SyncReport_Output(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS;
+  DECLARE_CCTK_PARAMETERS;
+
+  if (sync_report_every <= 0 || cctk_iteration % sync_report_every != 0)
+    return;
+
+  const auto entries = sync_entries();
+  CCTK_VINFO("Ghost zone bytes received per SYNC on this process (iteration "
+             "%d):",
+             cctk_iteration);
+  for (const auto &[level, level_bytes] : sync_report_bytes) {
+    CCTK_REAL total = 0;
+    for (size_t n = 0; n < entries.size(); ++n) {
+      CCTK_VINFO("  level %d  %-10s %-36s %14.0f bytes", level, entries[n].bin,
+                 entries[n].routine, double(level_bytes[n]));
+      total += level_bytes[n];
+    }
+    CCTK_VINFO("  level %d  total over all SYNCs: %.0f bytes", level,
+               double(total));
+  }
+  sync_report_bytes.clear();
 }
 
 } // namespace AsterX
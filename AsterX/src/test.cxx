@@ -27,6 +27,11 @@ extern "C" void AsterX_Test(CCTK_ARGUMENTS) {
 
     test_mp5(engine, repetitions);
 
+    test_curlA(engine, repetitions);
+    test_fd2_oneside_prod(engine, repetitions);
+
+    test_eos_hybrid(engine, repetitions);
+
   } else {
     CCTK_INFO("Skipping unit tests");
   }
@@ -1,6 +1,10 @@
 #ifndef ASTERX_TESTS_HXX
 #define ASTERX_TESTS_HXX
 
+#include <cctk.h>
+
+#include <vect.hxx>
+
 #include <cmath>
 #include <limits>
 #include <random>
@@ -35,6 +39,24 @@ bool isapprox(fp_type x, fp_type y, fp_type atol = 0.0) {
   return abs(x - y) <= max(atol, rtol * max(abs(x), abs(y)));
 }
 
+/**
+ * A grid point for testing stencils without a grid. It has the members of
+ * Loop::PointDesc that the stencils use.
+ */
+struct test_point {
+  using ivect = Arith::vect<int, 3>;
+  using rvect = Arith::vect<CCTK_REAL, 3>;
+
+  ivect I;
+  Arith::vect<ivect, 3> DI;
+  rvect DX;
+
+  test_point(const ivect &I_, const rvect &DX_) : I(I_), DX(DX_) {
+    for (int d = 0; d < 3; ++d)
+      DI[d] = ivect::unit(d);
+  }
+};
+
 void test_contraction_smat_upvec(std::mt19937_64 &engine, int repetitions);
 void test_contraction_upvec_downvec(std::mt19937_64 &engine, int repetitions);
 
@@ -46,6 +68,12 @@ void test_minmod(std::mt19937_64 &engine, int repetitions);
 
 void test_mp5(std::mt19937_64 &engine, int repetitions);
 
+void test_curlA(std::mt19937_64 &engine, int repetitions);
+
+void test_fd2_oneside_prod(std::mt19937_64 &engine, int repetitions);
+
+void test_eos_hybrid(std::mt19937_64 &engine, int repetitions);
+
 } // namespace AsterXTests
 
 #endif // ASTERX_TESTS_HXX
\ No newline at end of file
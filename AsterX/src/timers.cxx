@@ -0,0 +1,322 @@
+#include <AMReX_GpuDevice.H>
+
+#include <cctk.h>
+#include <cctk_Arguments.h>
+#include <cctk_Parameters.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "box_utils.hxx"
+#include "kernel_model.hxx"
+#include "timers.hxx"
+
+namespace AsterX {
+using namespace std;
+
+namespace {
+
+struct kernel_stats_t {
+  long long calls = 0;
+  CCTK_REAL cells = 0;
+  CCTK_REAL seconds = 0;
+};
+
+/* accumulated since the last report, by routine and level */
+mutex timer_mutex;
+map<pair<string, int>, kernel_stats_t> timer_stats;
+
+/* Events of the Chrome trace event format, with times in microseconds since
+ * trace_start. ph is 'X' for an interval and 'i' for an instant. */
+struct trace_event_t {
+  string name;
+  const char *cat;
+  char ph;
+  CCTK_REAL ts, dur;
+  int tid;
+  int level;
+  CCTK_REAL cells;
+  int boxes;
+};
+
+/* buffered since the last dump, guarded by timer_mutex */
+const chrono::steady_clock::time_point trace_start =
+    chrono::steady_clock::now();
+vector<trace_event_t> trace_events;
+bool trace_file_started = false;
+
+/* The last routine whose SYNC clauses have not been followed by another timed
+ * routine yet. The ghost zones are exchanged between the end of that routine
+ * and the start of the next one. */
+struct trace_pending_sync_t {
+  string routine;
+  int level;
+  CCTK_REAL end;
+};
+vector<trace_pending_sync_t> trace_pending_sync;
+
+/* index in trace_events of the regrid event, by iteration and level */
+map<pair<int, int>, size_t> trace_regrid_events;
+
+CCTK_REAL trace_time(const chrono::steady_clock::time_point t) {
+  return chrono::duration<CCTK_REAL, micro>(t - trace_start).count();
+}
+
+int thread_num() {
+#ifdef _OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+/* Whether a timer belongs to the routine, either as its main timer or as one
+ * of its sub-timers "<routine>/<part>" */
+bool is_part_of(const string &name, const string &routine) {
+  return name.compare(0, routine.size(), routine) == 0 &&
+         (name.size() == routine.size() || name[routine.size()] == '/');
+}
+
+/* Record the exchange after a pending SYNC when the routine name starts. Must
+ * be called with timer_mutex held. */
+void trace_close_sync(const string &name, const CCTK_REAL now) {
+  if (trace_pending_sync.empty() ||
+      is_part_of(name, trace_pending_sync[0].routine))
+    return;
+  const auto &sync = trace_pending_sync[0];
+  trace_events.push_back({"SYNC after " + sync.routine, "sync", 'X', sync.end,
+                          max(now - sync.end, CCTK_REAL(0)), thread_num(),
+                          sync.level, 0, 0});
+  trace_pending_sync.clear();
+}
+
+/* Mark that the ghost zones of the routine are exchanged once it finishes.
+ * Must be called with timer_mutex held. */
+void trace_open_sync(const string &routine, const int level,
+                     const CCTK_REAL end) {
+  if (!trace_pending_sync.empty() && trace_pending_sync[0].routine == routine) {
+    trace_pending_sync[0].end = max(trace_pending_sync[0].end, end);
+    return;
+  }
+  trace_pending_sync.assign(1, {routine, level, end});
+}
+
+/* Append the buffered events to asterx_trace.<process>.json. The closing
+ * bracket of the event array is optional in the trace event format, so that
+ * the file can be extended by later dumps and loaded at any time. The last
+ * dump closes it. */
+void trace_dump(const cGH *cctkGH, const bool last) {
+  DECLARE_CCTK_PARAMETERS;
+
+  const int rank = CCTK_MyProc(cctkGH);
+  ostringstream filename;
+  filename << out_dir << "/asterx_trace." << rank << ".json";
+  ofstream file(filename.str(), trace_file_started ? ios::app : ios::trunc);
+  if (!file)
+    CCTK_VERROR("Could not open trace file \"%s\"", filename.str().c_str());
+  if (!trace_file_started)
+    file << "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+         << ",\"args\":{\"name\":\"process " << rank << "\"}},\n";
+  trace_file_started = true;
+
+  // microseconds with nanosecond resolution
+  file << fixed;
+  file.precision(3);
+  for (const auto &e : trace_events) {
+    file << "{\"name\":\"" << e.name << "\",\"cat\":\"" << e.cat
+         << "\",\"ph\":\"" << e.ph << "\",\"ts\":" << e.ts;
+    if (e.ph == 'X')
+      file << ",\"dur\":" << e.dur;
+    else
+      file << ",\"s\":\"p\"";
+    file << ",\"pid\":" << rank << ",\"tid\":" << e.tid
+         << ",\"args\":{\"level\":" << e.level;
+    if (e.cells > 0)
+      file << ",\"cells\":" << (long long)e.cells;
+    if (e.boxes > 0)
+      file << ",\"boxes\":" << e.boxes;
+    file << "}},\n";
+  }
+  if (last)
+    file << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << rank
+         << ",\"args\":{\"sort_index\":" << rank << "}}\n]\n";
+  trace_events.clear();
+  trace_regrid_events.clear();
+}
+
+/* One line of the timer report. The rates of the analytic model are left
+ * empty for routines without one. */
+void report_line(const string &routine, const char *level,
+                 const kernel_stats_t &stats) {
+  const CCTK_REAL seconds = max(stats.seconds, CCTK_REAL(1.0e-12));
+  kernel_cost_t cost;
+  if (kernel_cost(routine, cost))
+    CCTK_VINFO("  %-36s %5s %8lld %14.0f %12.6f %12.3f %9.3f %9.3f %8.3f",
+               routine.c_str(), level, stats.calls, double(stats.cells),
+               double(stats.seconds), double(stats.cells / seconds / 1.0e6),
+               double(stats.cells * cost.bytes() / seconds / 1.0e9),
+               double(stats.cells * cost.flops / seconds / 1.0e9),
+               double(cost.flops / cost.bytes()));
+  else
+    CCTK_VINFO("  %-36s %5s %8lld %14.0f %12.6f %12.3f %9s %9s %8s",
+               routine.c_str(), level, stats.calls, double(stats.cells),
+               double(stats.seconds), double(stats.cells / seconds / 1.0e6),
+               "-", "-", "-");
+}
+
+} // namespace
+
+kernel_timer::kernel_timer(const char *name_, const cGH *cctkGH_,
+                           const bool syncs_)
+    : name(name_), cctkGH(cctkGH_), syncs(syncs_) {
+  DECLARE_CCTK_PARAMETERS;
+  active = timer_report_every > 0 || trace_timeline;
+  if (!active)
+    return;
+  start = chrono::steady_clock::now();
+  if (trace_timeline) {
+    const lock_guard<mutex> lock(timer_mutex);
+    trace_close_sync(name, trace_time(start));
+  }
+}
+
+kernel_timer::~kernel_timer() {
+  if (!active)
+    return;
+  DECLARE_CCTK_PARAMETERS;
+  amrex::Gpu::streamSynchronize();
+  const auto end = chrono::steady_clock::now();
+  const CCTK_REAL seconds = chrono::duration<CCTK_REAL>(end - start).count();
+  const int level = refinement_level(cctkGH);
+  const CCTK_REAL cells = interior_cells(cctkGH);
+
+  const lock_guard<mutex> lock(timer_mutex);
+  if (timer_report_every > 0) {
+    auto &stats = timer_stats[{name, level}];
+    ++stats.calls;
+    stats.cells += cells;
+    stats.seconds += seconds;
+  }
+  if (trace_timeline) {
+    trace_events.push_back({name, "kernel", 'X', trace_time(start),
+                            trace_time(end) - trace_time(start), thread_num(),
+                            level, cells, 1});
+    if (syncs)
+      trace_open_sync(name, level, trace_time(end));
+  }
+}
+
+void trace_sync(const char *routine) {
+  DECLARE_CCTK_PARAMETERS;
+  if (!trace_timeline)
+    return;
+  const lock_guard<mutex> lock(timer_mutex);
+  trace_open_sync(routine, -1, trace_time(chrono::steady_clock::now()));
+}
+
+/* one instant event per regridded level, counting its local boxes */
+extern "C" void AsterX_Trace_Regrid(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS;
+
+  const int level = refinement_level(cctkGH);
+  const CCTK_REAL now = trace_time(chrono::steady_clock::now());
+  const lock_guard<mutex> lock(timer_mutex);
+  const auto [it, is_new] = trace_regrid_events.insert(
+      {{cctk_iteration, level}, trace_events.size()});
+  if (is_new)
+    trace_events.push_back(
+        {"regrid", "regrid", 'i', now, 0, thread_num(), level, 0, 0});
+  auto &event = trace_events[it->second];
+  ++event.boxes;
+  event.cells += interior_cells(cctkGH);
+}
+
+extern "C" void AsterX_Trace_Output(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS;
+  DECLARE_CCTK_PARAMETERS;
+
+  if (trace_dump_every <= 0 || cctk_iteration % trace_dump_every != 0)
+    return;
+  const lock_guard<mutex> lock(timer_mutex);
+  trace_dump(cctkGH, false);
+}
+
+extern "C" void AsterX_Trace_Output_Final(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS;
+
+  const lock_guard<mutex> lock(timer_mutex);
+  trace_close_sync("", trace_time(chrono::steady_clock::now()));
+  trace_dump(cctkGH, true);
+}
+
+extern "C" void AsterX_TimerReport_Output(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS;
+  DECLARE_CCTK_PARAMETERS;
+
+  if (timer_report_every <= 0 || cctk_iteration % timer_report_every != 0)
+    return;
+
+  const int rank = CCTK_MyProc(cctkGH);
+  const lock_guard<mutex> lock(timer_mutex);
+
+  CCTK_VINFO("Kernel timers on process %d (iterations %d to %d):", rank,
+             max(cctk_iteration - int(timer_report_every) + 1, 0),
+             cctk_iteration);
+  CCTK_VINFO("  %-36s %5s %8s %14s %12s %12s %9s %9s %8s", "routine", "level",
+             "calls", "cells", "seconds", "Mzones/s", "GB/s", "GF/s",
+             "flop/B");
+  map<string, kernel_stats_t> totals;
+  for (const auto &[key, stats] : timer_stats) {
+    report_line(key.first, to_string(key.second).c_str(), stats);
+    auto &total = totals[key.first];
+    total.calls += stats.calls;
+    total.cells += stats.cells;
+    total.seconds += stats.seconds;
+  }
+  for (const auto &[routine, total] : totals)
+    report_line(routine, "all", total);
+
+  if (timer_csv) {
+    /* one file per process, started anew by the first report of a run */
+    static bool first_report = true;
+    ostringstream filename;
+    filename << out_dir << "/asterx_timers." << rank << ".csv";
+    ofstream file(filename.str(), first_report ? ios::trunc : ios::app);
+    if (!file)
+      CCTK_VERROR("Could not open timer file \"%s\"", filename.str().c_str());
+    if (first_report)
+      file << "iteration,rank,routine,level,calls,cells,seconds,"
+              "zone_updates_per_second,bytes_per_cell,flops_per_cell,"
+              "bytes_per_second,flops_per_second\n";
+    first_report = false;
+    file.precision(17);
+    for (const auto &[key, stats] : timer_stats) {
+      const CCTK_REAL seconds = max(stats.seconds, CCTK_REAL(1.0e-12));
+      file << cctk_iteration << "," << rank << "," << key.first << ","
+           << key.second << "," << stats.calls << "," << stats.cells << ","
+           << stats.seconds << "," << stats.cells / seconds;
+      kernel_cost_t cost;
+      if (kernel_cost(key.first, cost))
+        file << "," << cost.bytes() << "," << cost.flops << ","
+             << stats.cells * cost.bytes() / seconds << ","
+             << stats.cells * cost.flops / seconds;
+      else
+        file << ",,,,";
+      file << "\n";
+    }
+  }
+
+  timer_stats.clear();
+}
+
+} // namespace AsterX
@@ -0,0 +1,45 @@
+#ifndef ASTERX_TIMERS_HXX
+#define ASTERX_TIMERS_HXX
+
+#include <cctk.h>
+
+#include <chrono>
+
+namespace AsterX {
+
+/* Times a scheduled routine on one box. Create one at the top of the routine:
+ *
+ *   const kernel_timer timer("AsterX_RHS", cctkGH, true);
+ *
+ * The wall time, the number of interior cells and the refinement level of
+ * the box are accumulated per routine and level and reported every
+ * timer_report_every iterations, together with the memory and floating point
+ * throughput of the analytic model in kernel_model.hxx. Parts of a routine
+ * can be timed separately as "<routine>/<part>". With trace_timeline, every
+ * call is also recorded as an event of the timeline. syncs says that the
+ * routine has SYNC clauses; the timeline then shows the interval until the
+ * next timed routine starts, which contains the ghost zone exchange. Timers
+ * do nothing if neither is enabled. On GPUs the timer waits for the kernels
+ * of the routine to finish. Routines that skip a box, e.g. one that is not
+ * evolved, create the timer after that check. */
+class kernel_timer {
+  const char *name;
+  const cGH *cctkGH;
+  bool syncs;
+  bool active;
+  std::chrono::steady_clock::time_point start;
+
+public:
+  kernel_timer(const char *name, const cGH *cctkGH, bool syncs = false);
+  ~kernel_timer();
+  kernel_timer(const kernel_timer &) = delete;
+  kernel_timer &operator=(const kernel_timer &) = delete;
+};
+
+/* Record on the timeline that a routine without a timer, e.g. a global mode
+ * routine that exists only for its SYNC clauses, has finished */
+void trace_sync(const char *routine);
+
+} // namespace AsterX
+
+#endif // #ifndef ASTERX_TIMERS_HXX
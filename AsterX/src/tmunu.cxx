@@ -5,6 +5,7 @@
 #include <cctk_Parameters.h>
 
 #include "utils.hxx"
+#include "timers.hxx"
 #include <algorithm>
 #include <array>
 #include <cassert>
@@ -163,6 +164,7 @@ template <int interp_order> void Tmunu(CCTK_ARGUMENTS) {
 extern "C" void AsterX_Tmunu(CCTK_ARGUMENTS) {
   DECLARE_CCTK_ARGUMENTSX_AsterX_Tmunu;
   DECLARE_CCTK_PARAMETERS;
+  const kernel_timer timer("AsterX_Tmunu", cctkGH, true);
 
   switch (tmunu_interp_order) {
   case 2:
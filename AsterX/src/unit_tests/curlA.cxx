@@ -0,0 +1,94 @@
+#include <loop_device.hxx>
+
+#include <cctk.h>
+#include <cctk_Arguments.h>
+
+#include "../test.hxx"
+#include "../utils.hxx"
+
+#include <random>
+#include <vector>
+
+void AsterXTests::test_curlA(std::mt19937_64 &engine, int repetitions) {
+  using namespace Arith;
+  using namespace AsterX;
+  using namespace Loop;
+  using std::uniform_real_distribution;
+  using ivect = test_point::ivect;
+  using rvect = test_point::rvect;
+
+  // Vertices of a small grid
+  static constexpr const int n{4};
+  const GF3D2layout layout(ivect::pure(0), ivect::pure(n));
+
+  uniform_real_distribution<CCTK_REAL> real_distrib{-1.0, 1.0};
+  uniform_real_distribution<CCTK_REAL> positive_distrib{0.1, 1.0};
+
+  // The components of the curl can be close to zero
+  static constexpr const CCTK_REAL tolerance{1.0e-10};
+
+  for (int rep = 0; rep < repetitions; rep++) {
+
+    // A linear vector potential A_k = a_k + b_kl x^l
+    vec<CCTK_REAL, 3> a;
+    vec<vec<CCTK_REAL, 3>, 3> b;
+    rvect dx;
+    for (int k = 0; k < 3; k++) {
+      a(k) = real_distrib(engine);
+      dx[k] = positive_distrib(engine);
+      for (int l = 0; l < 3; l++)
+        b(k)(l) = real_distrib(engine);
+    }
+
+    std::vector<CCTK_REAL> data(3 * n * n * n);
+    for (int k = 0; k < 3; k++) {
+      const GF3D2<CCTK_REAL> gf_A(layout, &data[k * n * n * n]);
+      for (int i0 = 0; i0 < n; i0++)
+        for (int i1 = 0; i1 < n; i1++)
+          for (int i2 = 0; i2 < n; i2++) {
+            const ivect I =
+                i0 * ivect::unit(0) + i1 * ivect::unit(1) + i2 * ivect::unit(2);
+            gf_A(I) = a(k) + b(k)(0) * i0 * dx[0] + b(k)(1) * i1 * dx[1] +
+                      b(k)(2) * i2 * dx[2];
+          }
+    }
+    const vec<GF3D2<const CCTK_REAL>, 3> gf_Avecs{
+        GF3D2<const CCTK_REAL>(layout, &data[0]),
+        GF3D2<const CCTK_REAL>(layout, &data[n * n * n]),
+        GF3D2<const CCTK_REAL>(layout, &data[2 * n * n * n])};
+    const vec<CCTK_REAL, 3> idx{1 / dx[0], 1 / dx[1], 1 / dx[2]};
+    const test_point p(ivect::pure(1), dx);
+
+    CCTK_VINFO("Testing curl(A) of a linear vector potential, rep. %i", rep);
+    {
+      bool success{true};
+      for (int i = 0; i < 3; i++) {
+        const int j = (i + 1) % 3, k = (i + 2) % 3;
+        const CCTK_REAL expected_B{b(k)(j) - b(j)(k)};
+
+        for (int shift = 0; shift < 2; shift++) {
+          const CCTK_REAL B{calc_curlA(gf_Avecs, idx, p, i, shift)};
+          if (!isapprox(B, expected_B, tolerance)) {
+            CCTK_VINFO("  FAILED. Reason: Component %i of curl(A) on the face "
+                       "with shift %i expected to be %.16f, but instead got "
+                       "%.16f",
+                       i, shift, expected_B, B);
+            success = false;
+          }
+        }
+
+        const CCTK_REAL dB{calc_dB_from_A(gf_Avecs, idx, p, i)};
+        if (!isapprox(dB, expected_B, tolerance)) {
+          CCTK_VINFO("  FAILED. Reason: Component %i of the cell-centred "
+                     "curl(A) expected to be %.16f, but instead got %.16f",
+                     i, expected_B, dB);
+          success = false;
+        }
+      }
+
+      if (success) {
+        CCTK_VINFO("  PASSED.");
+      }
+    }
+  }
+}
@@ -0,0 +1,178 @@
+#include <cctk.h>
+#include <cctk_Arguments.h>
+
+#include <eos_hybrid.hxx>
+
+#include "../test.hxx"
+
+#include <cmath>
+#include <random>
+
+void AsterXTests::test_eos_hybrid(std::mt19937_64 &engine, int repetitions) {
+  using namespace EOSX;
+  using std::abs;
+  using std::nextafter;
+  using std::pow;
+  using std::uniform_real_distribution;
+
+  static constexpr const int n_pieces{3};
+  static constexpr const int n_points{16};
+
+  uniform_real_distribution<CCTK_REAL> gamma_distrib{1.3, 3.0};
+  uniform_real_distribution<CCTK_REAL> gamma_th_distrib{1.3, 2.0};
+  uniform_real_distribution<CCTK_REAL> k0_distrib{0.05, 0.15};
+  uniform_real_distribution<CCTK_REAL> log_rho_b_distrib{-5.0, -4.0};
+  uniform_real_distribution<CCTK_REAL> log_ratio_distrib{0.2, 1.0};
+  uniform_real_distribution<CCTK_REAL> log_rho_distrib{-7.0, -2.0};
+  uniform_real_distribution<CCTK_REAL> eps_th_distrib{0.01, 1.0};
+
+  // Central differences with step h: truncation error O(h^2)
+  static constexpr const CCTK_REAL fd_step{1.0e-6};
+  static constexpr const CCTK_REAL fd_tolerance{1.0e-6};
+
+  const eos::range rgeps(0, 100), rgrho(1.0e-10, 1.0), rgye(0, 1);
+
+  for (int rep = 0; rep < repetitions; rep++) {
+
+    CCTK_REAL gammas[n_pieces], rho_b[n_pieces - 1];
+    for (int i = 0; i < n_pieces; i++)
+      gammas[i] = gamma_distrib(engine);
+    rho_b[0] = pow(10.0, log_rho_b_distrib(engine));
+    for (int i = 1; i < n_pieces - 1; i++)
+      rho_b[i] = rho_b[i - 1] * pow(10.0, log_ratio_distrib(engine));
+    const CCTK_REAL k0{k0_distrib(engine)};
+    const CCTK_REAL gamma_th{gamma_th_distrib(engine)};
+
+    const eos_hybrid eos_hyb(n_pieces, gammas, rho_b, k0, gamma_th, 1.0,
+                             rgeps, rgrho, rgye);
+
+    CCTK_VINFO("Testing continuity of the cold hybrid EOS, rep. %i", rep);
+    {
+      bool success{true};
+      for (int i = 0; i < n_pieces - 1; i++) {
+        const CCTK_REAL rho_lo{rho_b[i]};
+        const CCTK_REAL rho_hi{nextafter(rho_b[i], 2 * rho_b[i])};
+        if (eos_hyb.piece(rho_lo) != i || eos_hyb.piece(rho_hi) != i + 1) {
+          CCTK_VINFO("  FAILED. Reason: Boundary %i expected to separate "
+                     "segments %i and %i, but instead got %i and %i",
+                     i, i, i + 1, eos_hyb.piece(rho_lo),
+                     eos_hyb.piece(rho_hi));
+          success = false;
+        }
+
+        CCTK_REAL press_lo, eps_lo, gamma_lo, press_hi, eps_hi, gamma_hi;
+        eos_hyb.cold_from_valid_rho(press_lo, eps_lo, gamma_lo, rho_lo);
+        eos_hyb.cold_from_valid_rho(press_hi, eps_hi, gamma_hi, rho_hi);
+        if (!isapprox(press_lo, press_hi)) {
+          CCTK_VINFO("  FAILED. Reason: Cold pressure at boundary %i jumps "
+                     "from %.16e to %.16e",
+                     i, press_lo, press_hi);
+          success = false;
+        }
+        if (!isapprox(eps_lo, eps_hi)) {
+          CCTK_VINFO("  FAILED. Reason: Cold specific energy at boundary %i "
+                     "jumps from %.16e to %.16e",
+                     i, eps_lo, eps_hi);
+          success = false;
+        }
+      }
+
+      if (success) {
+        CCTK_VINFO("  PASSED.");
+      }
+    }
+
+    CCTK_VINFO("Testing the thermal part of the hybrid EOS, rep. %i", rep);
+    {
+      bool success{true};
+      for (int n = 0; n < n_points; n++) {
+        const CCTK_REAL rho{pow(10.0, log_rho_distrib(engine))};
+        const CCTK_REAL ye{0.5};
+
+        int expected_piece{0};
+        while (expected_piece < n_pieces - 1 && rho > rho_b[expected_piece])
+          expected_piece++;
+        const int i{eos_hyb.piece(rho)};
+        if (i != expected_piece) {
+          CCTK_VINFO("  FAILED. Reason: Segment at rho = %.16e expected to be "
+                     "%i, but instead got %i",
+                     rho, expected_piece, i);
+          success = false;
+          continue;
+        }
+
+        CCTK_REAL press_cold, eps_cold, gamma_cold;
+        eos_hyb.cold_from_valid_rho(press_cold, eps_cold, gamma_cold, rho);
+        const CCTK_REAL eps_th{eps_th_distrib(engine)};
+        const CCTK_REAL eps{eps_cold + eps_th};
+
+        const CCTK_REAL expected_press{press_cold +
+                                       (gamma_th - 1) * rho * eps_th};
+        const CCTK_REAL press{
+            eos_hyb.press_from_valid_rho_eps_ye(rho, eps, ye)};
+        if (!isapprox(press, expected_press)) {
+          CCTK_VINFO("  FAILED. Reason: Pressure at rho = %.16e, eps = %.16e "
+                     "expected to be %.16e, but instead got %.16e",
+                     rho, eps, expected_press, press);
+          success = false;
+        }
+
+        const CCTK_REAL eps_inv{
+            eos_hyb.eps_from_valid_rho_press_ye(rho, press, ye)};
+        if (!isapprox(eps_inv, eps)) {
+          CCTK_VINFO("  FAILED. Reason: Inverting the pressure at rho = "
+                     "%.16e expected eps = %.16e, but instead got %.16e",
+                     rho, eps, eps_inv);
+          success = false;
+        }
+
+        CCTK_REAL press_d, dpdrho, dpdeps;
+        eos_hyb.press_derivs_from_valid_rho_eps_ye(press_d, dpdrho, dpdeps,
+                                                   rho, eps, ye);
+
+        const CCTK_REAL h_eps{fd_step * eps_th};
+        const CCTK_REAL fd_dpdeps{
+            (eos_hyb.press_from_valid_rho_eps_ye(rho, eps + h_eps, ye) -
+             eos_hyb.press_from_valid_rho_eps_ye(rho, eps - h_eps, ye)) /
+            (2 * h_eps)};
+        if (!isapprox(dpdeps, fd_dpdeps, fd_tolerance * abs(fd_dpdeps))) {
+          CCTK_VINFO("  FAILED. Reason: dP/deps at rho = %.16e expected to "
+                     "be %.16e, but instead got %.16e",
+                     rho, fd_dpdeps, dpdeps);
+          success = false;
+        }
+
+        // The cold part is not differentiable across a segment boundary
+        const CCTK_REAL h_rho{fd_step * rho};
+        if (eos_hyb.piece(rho - h_rho) == i &&
+            eos_hyb.piece(rho + h_rho) == i) {
+          const CCTK_REAL fd_dpdrho{
+              (eos_hyb.press_from_valid_rho_eps_ye(rho + h_rho, eps, ye) -
+               eos_hyb.press_from_valid_rho_eps_ye(rho - h_rho, eps, ye)) /
+              (2 * h_rho)};
+          if (!isapprox(dpdrho, fd_dpdrho, fd_tolerance * abs(fd_dpdrho))) {
+            CCTK_VINFO("  FAILED. Reason: dP/drho at rho = %.16e expected "
+                       "to be %.16e, but instead got %.16e",
+                       rho, fd_dpdrho, dpdrho);
+            success = false;
+          }
+        }
+
+        const eos_thermo th{
+            eos_hyb.thermo_from_valid_rho_eps_ye(rho, eps, ye)};
+        const CCTK_REAL csnd{eos_hyb.csnd_from_valid_rho_eps_ye(rho, eps, ye)};
+        if (!isapprox(th.press, press) || !isapprox(th.cs2, csnd * csnd)) {
+          CCTK_VINFO("  FAILED. Reason: Bundled thermodynamics at rho = "
+                     "%.16e disagree: press %.16e vs %.16e, cs2 %.16e vs "
+                     "%.16e",
+                     rho, th.press, press, th.cs2, csnd * csnd);
+          success = false;
+        }
+      }
+
+      if (success) {
+        CCTK_VINFO("  PASSED.");
+      }
+    }
+  }
+}
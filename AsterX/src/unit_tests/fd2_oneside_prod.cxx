@@ -0,0 +1,85 @@
+#include <loop_device.hxx>
+
+#include <cctk.h>
+#include <cctk_Arguments.h>
+
+#include "../test.hxx"
+#include "../fd.hxx"
+
+#include <random>
+#include <vector>
+
+void AsterXTests::test_fd2_oneside_prod(std::mt19937_64 &engine,
+                                        int repetitions) {
+  using namespace Arith;
+  using namespace AsterX;
+  using namespace Loop;
+  using std::uniform_real_distribution;
+  using ivect = test_point::ivect;
+  using rvect = test_point::rvect;
+
+  // Vertices of a small grid, the stencil reaches two points to either side
+  static constexpr const int n{5};
+  const GF3D2layout layout(ivect::pure(0), ivect::pure(n));
+
+  uniform_real_distribution<CCTK_REAL> real_distrib{-1.0, 1.0};
+  uniform_real_distribution<CCTK_REAL> positive_distrib{0.1, 1.0};
+
+  // The derivative can be close to zero
+  static constexpr const CCTK_REAL tolerance{1.0e-10};
+
+  for (int rep = 0; rep < repetitions; rep++) {
+
+    // Two linear functions f = a + b_l x^l and g = c + d_l x^l, whose product
+    // is quadratic
+    const CCTK_REAL a{real_distrib(engine)}, c{real_distrib(engine)};
+    rvect b, d, dx;
+    for (int l = 0; l < 3; l++) {
+      b[l] = real_distrib(engine);
+      d[l] = real_distrib(engine);
+      dx[l] = positive_distrib(engine);
+    }
+
+    std::vector<CCTK_REAL> data_f(n * n * n), data_g(n * n * n);
+    const GF3D2<CCTK_REAL> gf_f(layout, data_f.data());
+    const GF3D2<CCTK_REAL> gf_g(layout, data_g.data());
+    for (int i0 = 0; i0 < n; i0++)
+      for (int i1 = 0; i1 < n; i1++)
+        for (int i2 = 0; i2 < n; i2++) {
+          const ivect I =
+              i0 * ivect::unit(0) + i1 * ivect::unit(1) + i2 * ivect::unit(2);
+          gf_f(I) = a + b[0] * i0 * dx[0] + b[1] * i1 * dx[1] +
+                    b[2] * i2 * dx[2];
+          gf_g(I) = c + d[0] * i0 * dx[0] + d[1] * i1 * dx[1] +
+                    d[2] * i2 * dx[2];
+        }
+    const GF3D2<const CCTK_REAL> f(layout, data_f.data());
+    const GF3D2<const CCTK_REAL> g(layout, data_g.data());
+    const test_point p(ivect::pure(2), dx);
+
+    CCTK_VINFO("Testing one-sided FD2 derivative of a quadratic product, "
+               "rep. %i",
+               rep);
+    {
+      bool success{true};
+      for (int dir = 0; dir < 3; dir++) {
+        const CCTK_REAL expected{b[dir] * g(p.I) + d[dir] * f(p.I)};
+
+        for (int sign = -1; sign <= 1; sign += 2) {
+          const CCTK_REAL actual{
+              calc_fd2_v2v_oneside_prod(f, g, p, dir, sign)};
+          if (!isapprox(actual, expected, tolerance)) {
+            CCTK_VINFO("  FAILED. Reason: Derivative in direction %i with "
+                       "sign %i expected to be %.16f, but instead got %.16f",
+                       dir, sign, expected, actual);
+            success = false;
+          }
+        }
+      }
+
+      if (success) {
+        CCTK_VINFO("  PASSED.");
+      }
+    }
+  }
+}
@@ -17,6 +17,20 @@
 #include <fd.hxx>
 #include <interp.hxx>
 
+// Independent kernels of a stage can run as concurrent OpenMP tasks. The tasks
+// are picked up by idle threads when the calling thread is part of a team,
+// e.g. when CarpetX loops over blocks in parallel; otherwise they run in
+// order. Kernel launches on GPUs are asynchronous, there the kernels are
+// always launched in order.
+#define ASTERX_PRAGMA(x) _Pragma(#x)
+#if defined _OPENMP && !defined AMREX_USE_GPU
+#define ASTERX_KERNEL_TASKGROUP ASTERX_PRAGMA(omp taskgroup)
+#define ASTERX_KERNEL_TASK(cond) ASTERX_PRAGMA(omp task if (cond))
+#else
+#define ASTERX_KERNEL_TASKGROUP
+#define ASTERX_KERNEL_TASK(cond)
+#endif
+
 namespace AsterX {
 using namespace std;
 using namespace Loop;
@@ -169,6 +183,31 @@ calc_avg_neighbors(const vec<T, D> flag, const vec<T, D> u_nbs,
          CCTK_REAL(D);
 }
 
+// Computes component i of curl(A), i.e. the staggered densitized magnetic
+// field, on the face (staggered in direction i) at p.I + shift * p.DI[i].
+// p is a PointDesc, or any point with the members I and DI (see test.hxx)
+template <typename T, typename PointType>
+CCTK_DEVICE CCTK_HOST CCTK_ATTRIBUTE_ALWAYS_INLINE inline T
+calc_curlA(const vec<GF3D2<const T>, 3> &gf_Avecs, const vec<T, 3> &idx,
+           const PointType &p, const int i, const int shift) {
+  const int j = (i == 0) ? 1 : ((i == 1) ? 2 : 0);
+  const int k = (i == 0) ? 2 : ((i == 1) ? 0 : 1);
+  const auto I = p.I + p.DI[i] * shift;
+  return idx(j) * (gf_Avecs(k)(I + p.DI[j]) - gf_Avecs(k)(I)) -
+         idx(k) * (gf_Avecs(j)(I + p.DI[k]) - gf_Avecs(j)(I));
+}
+
+// Computes component i of the cell-centred densitized magnetic field
+// directly from the vector potential, using the same second order
+// interpolation as AsterX_ComputedBFromdBstag
+template <typename T, typename PointType>
+CCTK_DEVICE CCTK_HOST CCTK_ATTRIBUTE_ALWAYS_INLINE inline T
+calc_dB_from_A(const vec<GF3D2<const T>, 3> &gf_Avecs, const vec<T, 3> &idx,
+               const PointType &p, const int i) {
+  return 0.5 * (calc_curlA(gf_Avecs, idx, p, i, 0) +
+                calc_curlA(gf_Avecs, idx, p, i, 1));
+}
+
 } // namespace AsterX
 
 #endif // ASTERX_UTILS_HXX
@@ -0,0 +1,274 @@
+#include <loop.hxx>
+
+#include <cctk.h>
+#include <cctk_Arguments.h>
+#include <cctk_Parameters.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "eos_hybrid.hxx"
+#include "eos_idealgas.hxx"
+#include "eos_polytropic.hxx"
+#include "eos_tabulated3d.hxx"
+
+namespace EOSX {
+using namespace std;
+
+/* Microbenchmark and consistency check of the EOS implementations. All EOS
+ * calls are made on the host, one sample after another, which is how the
+ * AsterX kernels call them per grid point. */
+
+namespace {
+
+struct eos_samples {
+  vector<CCTK_REAL> rho, eps, ye;
+};
+
+// Keeps the compiler from removing the timed loops
+volatile CCTK_REAL benchmark_sink;
+
+/// Calls per second of f(i) over all samples, repeated nrep times
+template <typename F>
+CCTK_REAL calls_per_second(const int n, const int nrep, const F &f) {
+  CCTK_REAL sum = 0;
+  const auto t0 = chrono::steady_clock::now();
+  for (int rep = 0; rep < nrep; ++rep)
+    for (int i = 0; i < n; ++i)
+      sum += f(i);
+  const auto t1 = chrono::steady_clock::now();
+  benchmark_sink = sum;
+  const CCTK_REAL seconds = chrono::duration<CCTK_REAL>(t1 - t0).count();
+  return CCTK_REAL(n) * nrep / max(seconds, CCTK_REAL(1.0e-9));
+}
+
+/// Relative difference, 0 if both values vanish
+CCTK_REAL rel_diff(const CCTK_REAL a, const CCTK_REAL b) {
+  const CCTK_REAL scale = max(fabs(a), fabs(b));
+  return scale > 0 ? fabs(a - b) / scale : 0;
+}
+
+/// Samples uniform in log(rho), in eps over the valid range at (rho, Ye),
+/// and in Ye
+template <typename EOSType>
+eos_samples make_samples(const EOSType &eos_th, const int n) {
+  mt19937_64 gen(12345);
+  uniform_real_distribution<CCTK_REAL> uni(0, 1);
+  // Keep the density range finite for EOSs that are valid down to rho = 0
+  const CCTK_REAL logrho_max = log(eos_th.rgrho.max);
+  const CCTK_REAL logrho_min =
+      log(max(eos_th.rgrho.min, CCTK_REAL(1.0e-12) * eos_th.rgrho.max));
+
+  eos_samples s;
+  s.rho.resize(n);
+  s.eps.resize(n);
+  s.ye.resize(n);
+  for (int i = 0; i < n; ++i) {
+    s.rho[i] = exp(logrho_min + uni(gen) * (logrho_max - logrho_min));
+    s.ye[i] = eos_th.rgye.min + uni(gen) * (eos_th.rgye.max - eos_th.rgye.min);
+    const auto rg = eos_th.range_eps_from_valid_rho_ye(s.rho[i], s.ye[i]);
+    s.eps[i] = rg.min + uni(gen) * (rg.max - rg.min);
+  }
+  return s;
+}
+
+void report_rate(const char *name, const char *function, const CCTK_REAL rate) {
+  CCTK_VINFO("  %-10s %-36s %10.2f Mcalls/s", name, function, rate / 1.0e6);
+}
+
+void report_check(const char *name, const char *check, const CCTK_REAL err,
+                  const CCTK_REAL tolerance) {
+  CCTK_VINFO("  %-10s %-36s %10.3e max rel err", name, check, double(err));
+  if (!(err <= tolerance))
+    CCTK_VWARN(CCTK_WARN_ALERT,
+               "EOS benchmark: %s %s error %g exceeds tolerance %g", name,
+               check, double(err), double(tolerance));
+}
+
+/// Benchmark and check an EOS with the interface of class eos
+template <typename EOSType>
+void benchmark_eos(const char *name, const EOSType &eos_th, const int n,
+                   const int nrep, const CCTK_REAL tolerance) {
+  const eos_samples s = make_samples(eos_th, n);
+  const CCTK_REAL *const rho = s.rho.data();
+  const CCTK_REAL *const eps = s.eps.data();
+  const CCTK_REAL *const ye = s.ye.data();
+
+  vector<CCTK_REAL> press(n), temp(n);
+  for (int i = 0; i < n; ++i) {
+    press[i] = eos_th.press_from_valid_rho_eps_ye(rho[i], eps[i], ye[i]);
+    temp[i] = eos_th.temp_from_valid_rho_eps_ye(rho[i], eps[i], ye[i]);
+  }
+
+  // Scalar queries, one quantity per call
+  report_rate(name, "press_from_valid_rho_eps_ye",
+              calls_per_second(n, nrep, [&](int i) {
+                return eos_th.press_from_valid_rho_eps_ye(rho[i], eps[i],
+                                                          ye[i]);
+              }));
+  report_rate(name, "eps_from_valid_rho_press_ye",
+              calls_per_second(n, nrep, [&](int i) {
+                return eos_th.eps_from_valid_rho_press_ye(rho[i], press[i],
+                                                          ye[i]);
+              }));
+  report_rate(name, "csnd_from_valid_rho_eps_ye",
+              calls_per_second(n, nrep, [&](int i) {
+                return eos_th.csnd_from_valid_rho_eps_ye(rho[i], eps[i],
+                                                         ye[i]);
+              }));
+  report_rate(name, "temp_from_valid_rho_eps_ye",
+              calls_per_second(n, nrep, [&](int i) {
+                return eos_th.temp_from_valid_rho_eps_ye(rho[i], eps[i],
+                                                         ye[i]);
+              }));
+  report_rate(name, "eps_from_valid_rho_temp_ye",
+              calls_per_second(n, nrep, [&](int i) {
+                return eos_th.eps_from_valid_rho_temp_ye(rho[i], temp[i],
+                                                         ye[i]);
+              }));
+  report_rate(name, "press_derivs_from_valid_rho_eps_ye",
+              calls_per_second(n, nrep, [&](int i) {
+                CCTK_REAL p, dpdrho, dpdeps;
+                eos_th.press_derivs_from_valid_rho_eps_ye(p, dpdrho, dpdeps,
+                                                          rho[i], eps[i],
+                                                          ye[i]);
+                return p + dpdrho + dpdeps;
+              }));
+
+  // Batched queries, all quantities from one call
+  report_rate(name, "thermo_from_valid_rho_eps_ye",
+              calls_per_second(n, nrep, [&](int i) {
+                const eos_thermo t =
+                    eos_th.thermo_from_valid_rho_eps_ye(rho[i], eps[i], ye[i]);
+                return t.press + t.cs2 + t.h + t.dpdrho + t.dpdeps;
+              }));
+  report_rate(name, "thermo_from_valid_rho_press_ye",
+              calls_per_second(n, nrep, [&](int i) {
+                const eos_thermo t = eos_th.thermo_from_valid_rho_press_ye(
+                    rho[i], press[i], ye[i]);
+                return t.eps + t.cs2 + t.h + t.dpdrho + t.dpdeps;
+              }));
+
+  // Thermodynamic consistency
+  CCTK_REAL err_press = 0, err_temp = 0, err_thermo = 0;
+  int bad_cs2 = 0;
+  for (int i = 0; i < n; ++i) {
+    const CCTK_REAL eps_p =
+        eos_th.eps_from_valid_rho_press_ye(rho[i], press[i], ye[i]);
+    const CCTK_REAL eps_t =
+        eos_th.eps_from_valid_rho_temp_ye(rho[i], temp[i], ye[i]);
+    err_press = max(err_press, rel_diff(eps[i], eps_p));
+    err_temp = max(err_temp, rel_diff(eps[i], eps_t));
+    const CCTK_REAL csnd =
+        eos_th.csnd_from_valid_rho_eps_ye(rho[i], eps[i], ye[i]);
+    const eos_thermo t =
+        eos_th.thermo_from_valid_rho_eps_ye(rho[i], eps[i], ye[i]);
+    const CCTK_REAL cs2 = csnd * csnd;
+    err_thermo =
+        max({err_thermo, rel_diff(t.press, press[i]), rel_diff(t.cs2, cs2)});
+    if (!(cs2 >= 0 && cs2 < 1))
+      ++bad_cs2;
+  }
+  report_check(name, "eps -> press -> eps", err_press, tolerance);
+  report_check(name, "eps -> temp -> eps", err_temp, tolerance);
+  report_check(name, "thermo vs. scalar queries", err_thermo, tolerance);
+  CCTK_VINFO("  %-10s %-36s %10d of %d samples", name, "cs2 outside [0,1)",
+             bad_cs2, n);
+  if (bad_cs2 > 0)
+    CCTK_VWARN(CCTK_WARN_ALERT,
+               "EOS benchmark: %s has a sound speed outside [0,1) for %d "
+               "samples",
+               name, bad_cs2);
+}
+
+/// Benchmark and check a cold EOS with the interface of class eos_1p
+void benchmark_polytrope(const char *name, const eos_polytrope &eos_cold,
+                         const CCTK_REAL rho_max, const int n, const int nrep,
+                         const CCTK_REAL tolerance) {
+  mt19937_64 gen(12345);
+  uniform_real_distribution<CCTK_REAL> uni(0, 1);
+  const CCTK_REAL logrho_max = log(rho_max);
+  const CCTK_REAL logrho_min = log(CCTK_REAL(1.0e-12) * rho_max);
+  vector<CCTK_REAL> rho(n), gm1(n), press(n);
+  for (int i = 0; i < n; ++i) {
+    rho[i] = exp(logrho_min + uni(gen) * (logrho_max - logrho_min));
+    gm1[i] = eos_cold.gm1_from_valid_rmd(rho[i]);
+    press[i] = eos_cold.p_from_valid_gm1(gm1[i]);
+  }
+
+  report_rate(name, "gm1_from_valid_rmd", calls_per_second(n, nrep, [&](int i) {
+                return eos_cold.gm1_from_valid_rmd(rho[i]);
+              }));
+  report_rate(name, "gm1_from_valid_p", calls_per_second(n, nrep, [&](int i) {
+                return eos_cold.gm1_from_valid_p(press[i]);
+              }));
+  report_rate(name, "p_from_valid_gm1", calls_per_second(n, nrep, [&](int i) {
+                return eos_cold.p_from_valid_gm1(gm1[i]);
+              }));
+  report_rate(name, "sed_from_valid_gm1", calls_per_second(n, nrep, [&](int i) {
+                return eos_cold.sed_from_valid_gm1(gm1[i]);
+              }));
+  report_rate(name, "csnd2_from_valid_gm1",
+              calls_per_second(n, nrep, [&](int i) {
+                return eos_cold.csnd2_from_valid_gm1(gm1[i]);
+              }));
+
+  CCTK_REAL err_press = 0;
+  int bad_cs2 = 0;
+  for (int i = 0; i < n; ++i) {
+    const CCTK_REAL rho_p =
+        eos_cold.rmd_from_valid_gm1(eos_cold.gm1_from_valid_p(press[i]));
+    err_press = max(err_press, rel_diff(rho[i], rho_p));
+    const CCTK_REAL cs2 = eos_cold.csnd2_from_valid_gm1(gm1[i]);
+    if (!(cs2 >= 0 && cs2 < 1))
+      ++bad_cs2;
+  }
+  report_check(name, "rho -> press -> rho", err_press, tolerance);
+  CCTK_VINFO("  %-10s %-36s %10d of %d samples", name, "cs2 outside [0,1)",
+             bad_cs2, n);
+  if (bad_cs2 > 0)
+    CCTK_VWARN(CCTK_WARN_ALERT,
+               "EOS benchmark: %s has a sound speed outside [0,1) for %d "
+               "samples",
+               name, bad_cs2);
+}
+
+} // namespace
+
+extern "C" void EOSX_Benchmark(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_PARAMETERS;
+
+  const int n = benchmark_samples;
+  const int nrep = benchmark_repetitions;
+  const CCTK_REAL tol = benchmark_tolerance;
+  CCTK_VINFO("EOS benchmark: %d samples x %d repetitions on the host", n,
+             nrep);
+
+  eos::range rgeps(eps_min, eps_max), rgrho(rho_min, rho_max),
+      rgye(ye_min, ye_max);
+
+  const CCTK_REAL n_poly = 1 / (poly_gamma - 1);
+  const eos_polytrope eos_poly(n_poly, pow(poly_k, -n_poly), rho_max);
+  benchmark_polytrope("Polytrope", eos_poly, rho_max, n, nrep, tol);
+
+  const eos_idealgas eos_ig(gl_gamma, particle_mass, rgeps, rgrho, rgye);
+  benchmark_eos("IdealGas", eos_ig, n, nrep, tol);
+
+  const eos_hybrid eos_hyb(hybrid_n_pieces, hybrid_gamma, hybrid_rho_b,
+                           hybrid_k0, hybrid_gamma_th, particle_mass, rgeps,
+                           rgrho, rgye);
+  benchmark_eos("Hybrid", eos_hyb, n, nrep, tol);
+
+  // The table is only read if it is used for the evolution
+  if (CCTK_EQUALS(evolution_eos, "Tabulated")) {
+    if (tabulated_eos_reduced_precision)
+      benchmark_eos("TabulatedF", get_eos_tabulated3d_float(), n, nrep, tol);
+    else
+      benchmark_eos("Tabulated", get_eos_tabulated3d(), n, nrep, tol);
+  }
+}
+
+} // namespace EOSX
@@ -128,6 +128,12 @@ public:
   CCTK_DEVICE CCTK_HOST CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
   csnd_from_valid_rho_eps_ye(const CCTK_REAL rho, const CCTK_REAL eps,
                              const CCTK_REAL ye) const;
+  CCTK_DEVICE CCTK_HOST CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+  thermo_from_valid_rho_eps_ye(const CCTK_REAL rho, const CCTK_REAL eps,
+                               const CCTK_REAL ye) const;
+  CCTK_DEVICE CCTK_HOST CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+  thermo_from_valid_rho_press_ye(const CCTK_REAL rho, const CCTK_REAL press,
+                                 const CCTK_REAL ye) const;
 };
 
 } // namespace EOSX
@@ -0,0 +1,66 @@
+#include <loop.hxx>
+
+#include <cctk.h>
+#include <cctk_Parameters.h>
+
+#include <cmath>
+
+#include "eos_dispatch.hxx"
+
+namespace EOSX {
+using namespace std;
+
+/* The EOS parameters are not steerable during the evolution, so that the
+ * objects are built on first use and kept for the whole run. Function-local
+ * statics are initialized thread-safely. */
+
+eos_3p_t get_eos_3p_type() {
+  static const eos_3p_t eostype = [] {
+    DECLARE_CCTK_PARAMETERS;
+    if (CCTK_EQUALS(evolution_eos, "IdealGas"))
+      return eos_3p_t::IdealGas;
+    if (CCTK_EQUALS(evolution_eos, "Hybrid"))
+      return eos_3p_t::Hybrid;
+    if (CCTK_EQUALS(evolution_eos, "Tabulated"))
+      return tabulated_eos_reduced_precision ? eos_3p_t::TabulatedFloat
+                                             : eos_3p_t::Tabulated;
+    CCTK_ERROR("Unknown value for parameter \"evolution_eos\"");
+  }();
+  return eostype;
+}
+
+const eos_idealgas &get_eos_idealgas() {
+  static const eos_idealgas eos_th = [] {
+    DECLARE_CCTK_PARAMETERS;
+    const eos::range rgeps(eps_min, eps_max), rgrho(rho_min, rho_max),
+        rgye(ye_min, ye_max);
+    return eos_idealgas(gl_gamma, particle_mass, rgeps, rgrho, rgye);
+  }();
+  return eos_th;
+}
+
+const eos_hybrid &get_eos_hybrid() {
+  static const eos_hybrid eos_th = [] {
+    DECLARE_CCTK_PARAMETERS;
+    const eos::range rgeps(eps_min, eps_max), rgrho(rho_min, rho_max),
+        rgye(ye_min, ye_max);
+    return eos_hybrid(hybrid_n_pieces, hybrid_gamma, hybrid_rho_b, hybrid_k0,
+                      hybrid_gamma_th, particle_mass, rgeps, rgrho, rgye);
+  }();
+  return eos_th;
+}
+
+const eos_polytrope &get_eos_cold() {
+  static const eos_polytrope eos_cold = [] {
+    DECLARE_CCTK_PARAMETERS;
+    const bool hybrid = get_eos_3p_type() == eos_3p_t::Hybrid;
+    const CCTK_REAL gamma = hybrid ? hybrid_gamma[0] : poly_gamma;
+    const CCTK_REAL k = hybrid ? hybrid_k0 : poly_k;
+    const CCTK_REAL n = 1 / (gamma - 1); // Polytropic index
+    const CCTK_REAL rmd_p = pow(k, -n);  // Polytropic density scale
+    return eos_polytrope(n, rmd_p, rho_max);
+  }();
+  return eos_cold;
+}
+
+} // namespace EOSX
@@ -0,0 +1,68 @@
+/*! \file eos_dispatch.hxx
+\brief Construction of and dispatch to the evolution EOS
+
+The EOS objects selected by EOSX::evolution_eos are built once from the
+parameters of EOSX and cached. dispatch_eos_3p() calls a generic callable
+with the EOS of the concrete type, so that kernel templates are instantiated
+(and fully inlined) for each EOS without repeating the selection at every
+call site:
+
+  dispatch_eos_3p([&](const auto &eos_th) { MyKernel(cctkGH, eos_th); });
+
+The EOS objects are trivially copyable and can be captured by value in
+device lambdas.
+*/
+
+#ifndef EOS_DISPATCH_HXX
+#define EOS_DISPATCH_HXX
+
+#include <cctk.h>
+
+#include "eos_hybrid.hxx"
+#include "eos_idealgas.hxx"
+#include "eos_polytropic.hxx"
+#include "eos_tabulated3d.hxx"
+
+namespace EOSX {
+
+/// Evolution EOS, see EOSX::evolution_eos and
+/// EOSX::tabulated_eos_reduced_precision
+enum class eos_3p_t { IdealGas, Hybrid, Tabulated, TabulatedFloat };
+
+/// Type of the evolution EOS
+eos_3p_t get_eos_3p_type();
+
+/// Evolution EOS objects, valid if selected by EOSX::evolution_eos
+const eos_idealgas &get_eos_idealgas();
+const eos_hybrid &get_eos_hybrid();
+// get_eos_tabulated3d() and get_eos_tabulated3d_float() are declared in
+// eos_tabulated3d.hxx
+
+/// Polytrope describing the evolution EOS at low density and temperature,
+/// e.g. for an atmosphere: the lowest density segment of the hybrid EOS, or
+/// EOSX::poly_gamma and EOSX::poly_k otherwise
+const eos_polytrope &get_eos_cold();
+
+/// Call f with the evolution EOS
+template <typename F> inline void dispatch_eos_3p(F &&f) {
+  switch (get_eos_3p_type()) {
+  case eos_3p_t::IdealGas:
+    f(get_eos_idealgas());
+    break;
+  case eos_3p_t::Hybrid:
+    f(get_eos_hybrid());
+    break;
+  case eos_3p_t::Tabulated:
+    f(get_eos_tabulated3d());
+    break;
+  case eos_3p_t::TabulatedFloat:
+    f(get_eos_tabulated3d_float());
+    break;
+  default:
+    assert(0);
+  }
+}
+
+} // namespace EOSX
+
+#endif
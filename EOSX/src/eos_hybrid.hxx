@@ -0,0 +1,333 @@
+/*! \file eos_hybrid.hxx
+\brief Piecewise polytropic EOS with a thermal ideal gas component
+
+The cold part is a piecewise polytrope with up to eos_hybrid::max_pieces
+segments,
+\f[ P_c = K_i \rho^{\Gamma_i}, \qquad
+    \epsilon_c = a_i + \frac{K_i \rho^{\Gamma_i - 1}}{\Gamma_i - 1}
+    \qquad \text{for} \quad \rho_{i-1} < \rho \le \rho_i , \f]
+where \f$ K_i \f$ and \f$ a_i \f$ follow from continuity of pressure and
+specific energy. The thermal part is
+\f$ P_{th} = (\Gamma_{th} - 1) \rho (\epsilon - \epsilon_c) \f$.
+
+The segment is found without branches by counting the thresholds below
+\f$ \rho \f$ over a fixed number of entries (unused thresholds are
+infinite), so that the lookup vectorizes.
+*/
+
+#ifndef EOS_HYBRID_HXX
+#define EOS_HYBRID_HXX
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "eos.hxx"
+using namespace std;
+
+namespace EOSX {
+
+class eos_hybrid : public eos {
+public:
+  static constexpr int max_pieces = 8;
+
+  /// Not defined for this EOS. Only present so that code written for the
+  /// ideal gas compiles; solvers relying on it must not be used.
+  CCTK_REAL gamma;
+  CCTK_REAL gamma_th, gm1_th, temp_over_eps;
+  range rgeps;
+
+  int n_pieces;
+  CCTK_REAL rho_b[max_pieces - 1]; ///< Upper density of each segment
+  CCTK_REAL k[max_pieces];         ///< \f$ K_i \f$
+  CCTK_REAL gammas[max_pieces];    ///< \f$ \Gamma_i \f$
+  CCTK_REAL a[max_pieces];         ///< \f$ a_i \f$
+
+  // constructor
+  CCTK_HOST CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_hybrid(
+      int n_pieces_, const CCTK_REAL *gammas_, const CCTK_REAL *rho_b_,
+      CCTK_REAL k0_, CCTK_REAL gamma_th_, CCTK_REAL umass_,
+      const range &rgeps_, const range &rgrho_, const range &rgye_);
+
+  /// The temperature is found without iteration; the guess is ignored
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline const eos_hybrid &
+  with_temp_guess(const CCTK_REAL temp ///< Temperature guess \f$ T \f$
+  ) const;
+
+  /// Index of the segment containing rho
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline int
+  piece(const CCTK_REAL rho) const;
+
+  /// Cold pressure and specific energy
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline void
+  cold_from_valid_rho(CCTK_REAL &press_cold, CCTK_REAL &eps_cold,
+                      CCTK_REAL &gamma_cold, const CCTK_REAL rho) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  press_from_valid_rho_eps_ye(
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL eps, ///< Specific internal energy \f$ \epsilon \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  eps_from_valid_rho_press_ye(
+      const CCTK_REAL rho,   ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL press, ///< Pressure \f$ P \f$
+      const CCTK_REAL ye     ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  csnd_from_valid_rho_eps_ye(
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL eps, ///< Specific internal energy \f$ \epsilon \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  temp_from_valid_rho_eps_ye(
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL eps, ///< Specific internal energy \f$ \epsilon \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline void
+  press_derivs_from_valid_rho_eps_ye(
+      CCTK_REAL &press,  ///< Pressure \f$ P \f$
+      CCTK_REAL &dpdrho, ///< Partial derivative \f$ \frac{\partial P}{\partial
+                         ///< \rho} \f$
+      CCTK_REAL &dpdeps, ///< Partial derivative \f$ \frac{\partial P}{\partial
+                         ///< \epsilon} \f$
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL eps, ///< Specific internal energy \f$ \epsilon \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  entropy_from_valid_rho_temp_ye(
+      const CCTK_REAL rho,  ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL temp, ///< Temperature \f$ T \f$
+      const CCTK_REAL ye    ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  entropy_from_valid_rho_eps_ye(
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL eps, ///< Specific internal energy \f$ \epsilon \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  eps_from_valid_rho_temp_ye(
+      const CCTK_REAL rho,  ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL temp, ///< Temperature \f$ T \f$ in MeV
+      const CCTK_REAL ye    ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  /// Pressure, sound speed, enthalpy and pressure derivatives from a single
+  /// EOS evaluation
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+  thermo_from_valid_rho_eps_ye(
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL eps, ///< Specific internal energy \f$ \epsilon \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  /// Specific energy, sound speed, enthalpy and pressure derivatives from a
+  /// single EOS evaluation
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+  thermo_from_valid_rho_press_ye(
+      const CCTK_REAL rho,   ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL press, ///< Pressure \f$ P \f$
+      const CCTK_REAL ye     ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline range
+  range_eps_from_valid_rho_ye(
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+};
+
+// constructor
+CCTK_HOST CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_hybrid::eos_hybrid(
+    int n_pieces_, const CCTK_REAL *gammas_, const CCTK_REAL *rho_b_,
+    CCTK_REAL k0_, CCTK_REAL gamma_th_, CCTK_REAL umass_, const range &rgeps_,
+    const range &rgrho_, const range &rgye_)
+    : gamma(nan()), gamma_th(gamma_th_), gm1_th(gamma_th_ - 1), rgeps(rgeps_),
+      n_pieces(n_pieces_) {
+  if (n_pieces < 1 || n_pieces > max_pieces)
+    CCTK_VERROR("Hybrid EOS: invalid number of segments %d, must be between "
+                "1 and %d",
+                n_pieces, max_pieces);
+  // Unused segments repeat the last one and are never selected
+  for (int i = 0; i < max_pieces; ++i)
+    gammas[i] = gammas_[min(i, n_pieces - 1)];
+  for (int i = 0; i < max_pieces - 1; ++i)
+    rho_b[i] = i < n_pieces - 1 ? rho_b_[i]
+                                  : numeric_limits<CCTK_REAL>::infinity();
+
+  // Continuity of pressure and specific energy at the segment boundaries
+  k[0] = k0_;
+  a[0] = 0;
+  for (int i = 1; i < max_pieces; ++i) {
+    if (i < n_pieces) {
+      const CCTK_REAL rb = rho_b[i - 1];
+      k[i] = k[i - 1] * pow(rb, gammas[i - 1] - gammas[i]);
+      a[i] = a[i - 1] +
+             k[i - 1] * pow(rb, gammas[i - 1] - 1) / (gammas[i - 1] - 1) -
+             k[i] * pow(rb, gammas[i] - 1) / (gammas[i] - 1);
+    } else {
+      k[i] = k[i - 1];
+      a[i] = a[i - 1];
+    }
+  }
+
+  set_range_rho(rgrho_);
+  set_range_ye(rgye_);
+  temp_over_eps = gm1_th * umass_;
+  set_range_temp(range(temp_over_eps * rgeps.min, temp_over_eps * rgeps.max));
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline const eos_hybrid &
+eos_hybrid::with_temp_guess(const CCTK_REAL temp) const {
+  return *this;
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline int
+eos_hybrid::piece(const CCTK_REAL rho) const {
+  // Fixed trip count, fully unrolled by the compiler
+  int i = 0;
+  for (int j = 0; j < max_pieces - 1; ++j)
+    i += rho > rho_b[j];
+  return i;
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline void
+eos_hybrid::cold_from_valid_rho(CCTK_REAL &press_cold, CCTK_REAL &eps_cold,
+                                CCTK_REAL &gamma_cold,
+                                const CCTK_REAL rho) const {
+  const int i = piece(rho);
+  gamma_cold = gammas[i];
+  press_cold = k[i] * pow(rho, gamma_cold);
+  eps_cold = a[i] + press_cold / (rho * (gamma_cold - 1));
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_hybrid::press_from_valid_rho_eps_ye(const CCTK_REAL rho,
+                                        const CCTK_REAL eps,
+                                        const CCTK_REAL ye) const {
+  CCTK_REAL press_cold, eps_cold, gamma_cold;
+  cold_from_valid_rho(press_cold, eps_cold, gamma_cold, rho);
+  return press_cold + gm1_th * rho * max(eps - eps_cold, CCTK_REAL(0));
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_hybrid::eps_from_valid_rho_press_ye(const CCTK_REAL rho,
+                                        const CCTK_REAL press,
+                                        const CCTK_REAL ye) const {
+  CCTK_REAL press_cold, eps_cold, gamma_cold;
+  cold_from_valid_rho(press_cold, eps_cold, gamma_cold, rho);
+  return eps_cold + max(press - press_cold, CCTK_REAL(0)) / (gm1_th * rho);
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_hybrid::csnd_from_valid_rho_eps_ye(const CCTK_REAL rho,
+                                       const CCTK_REAL eps,
+                                       const CCTK_REAL ye) const {
+  CCTK_REAL press, dpdrho, dpdeps;
+  press_derivs_from_valid_rho_eps_ye(press, dpdrho, dpdeps, rho, eps, ye);
+  const CCTK_REAL h = 1 + eps + press / rho;
+  return sqrt(max((dpdrho + dpdeps * press / (rho * rho)) / h, CCTK_REAL(0)));
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_hybrid::temp_from_valid_rho_eps_ye(const CCTK_REAL rho,
+                                       const CCTK_REAL eps,
+                                       const CCTK_REAL ye) const {
+  CCTK_REAL press_cold, eps_cold, gamma_cold;
+  cold_from_valid_rho(press_cold, eps_cold, gamma_cold, rho);
+  return temp_over_eps * max(eps - eps_cold, CCTK_REAL(0));
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline void
+eos_hybrid::press_derivs_from_valid_rho_eps_ye(
+    CCTK_REAL &press, CCTK_REAL &dpdrho, CCTK_REAL &dpdeps, const CCTK_REAL rho,
+    const CCTK_REAL eps, const CCTK_REAL ye) const {
+  CCTK_REAL press_cold, eps_cold, gamma_cold;
+  cold_from_valid_rho(press_cold, eps_cold, gamma_cold, rho);
+  const CCTK_REAL eps_th = max(eps - eps_cold, CCTK_REAL(0));
+  press = press_cold + gm1_th * rho * eps_th;
+  // d eps_cold / d rho = P_cold / rho^2
+  dpdrho = (gamma_cold - gm1_th) * press_cold / rho + gm1_th * eps_th;
+  dpdeps = gm1_th * rho;
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_hybrid::entropy_from_valid_rho_temp_ye(const CCTK_REAL rho,
+                                           const CCTK_REAL temp,
+                                           const CCTK_REAL ye) const {
+  return log(temp * pow(rho, -gm1_th) / temp_over_eps);
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_hybrid::entropy_from_valid_rho_eps_ye(const CCTK_REAL rho,
+                                          const CCTK_REAL eps,
+                                          const CCTK_REAL ye) const {
+  return entropy_from_valid_rho_temp_ye(
+      rho, temp_from_valid_rho_eps_ye(rho, eps, ye), ye);
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_hybrid::eps_from_valid_rho_temp_ye(const CCTK_REAL rho,
+                                       const CCTK_REAL temp,
+                                       const CCTK_REAL ye) const {
+  CCTK_REAL press_cold, eps_cold, gamma_cold;
+  cold_from_valid_rho(press_cold, eps_cold, gamma_cold, rho);
+  return eps_cold + temp / temp_over_eps;
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+eos_hybrid::thermo_from_valid_rho_eps_ye(const CCTK_REAL rho,
+                                         const CCTK_REAL eps,
+                                         const CCTK_REAL ye) const {
+  eos_thermo th;
+  th.eps = eps;
+  press_derivs_from_valid_rho_eps_ye(th.press, th.dpdrho, th.dpdeps, rho, eps,
+                                     ye);
+  th.h = 1 + eps + th.press / rho;
+  th.cs2 = max((th.dpdrho + th.dpdeps * th.press / (rho * rho)) / th.h,
+               CCTK_REAL(0));
+  return th;
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+eos_hybrid::thermo_from_valid_rho_press_ye(const CCTK_REAL rho,
+                                           const CCTK_REAL press,
+                                           const CCTK_REAL ye) const {
+  CCTK_REAL press_cold, eps_cold, gamma_cold;
+  cold_from_valid_rho(press_cold, eps_cold, gamma_cold, rho);
+  const CCTK_REAL eps_th =
+      max(press - press_cold, CCTK_REAL(0)) / (gm1_th * rho);
+  eos_thermo th;
+  th.eps = eps_cold + eps_th;
+  th.press = press_cold + gm1_th * rho * eps_th;
+  th.dpdrho = (gamma_cold - gm1_th) * press_cold / rho + gm1_th * eps_th;
+  th.dpdeps = gm1_th * rho;
+  th.h = 1 + th.eps + th.press / rho;
+  th.cs2 = max((th.dpdrho + th.dpdeps * th.press / (rho * rho)) / th.h,
+               CCTK_REAL(0));
+  return th;
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos::range
+eos_hybrid::range_eps_from_valid_rho_ye(const CCTK_REAL rho,
+                                        const CCTK_REAL ye) const {
+  CCTK_REAL press_cold, eps_cold, gamma_cold;
+  cold_from_valid_rho(press_cold, eps_cold, gamma_cold, rho);
+  return range(max(eps_cold, rgeps.min), rgeps.max);
+}
+
+} // namespace EOSX
+
+#endif
@@ -23,6 +23,11 @@ public:
   // destructor
   CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline ~eos_idealgas();
 
+  /// The temperature is found without iteration; the guess is ignored
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline const eos_idealgas &
+  with_temp_guess(const CCTK_REAL temp ///< Temperature guess \f$ T \f$
+  ) const;
+
   CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
   press_from_valid_rho_eps_ye(
       const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
@@ -84,6 +89,24 @@ public:
       const CCTK_REAL ye    ///< Electron fraction \f$ Y_e \f$
   ) const;
 
+  /// Pressure, sound speed, enthalpy and pressure derivatives from a single
+  /// EOS evaluation
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+  thermo_from_valid_rho_eps_ye(
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL eps, ///< Specific internal energy \f$ \epsilon \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  /// Specific energy, sound speed, enthalpy and pressure derivatives from a
+  /// single EOS evaluation
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+  thermo_from_valid_rho_press_ye(
+      const CCTK_REAL rho,   ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL press, ///< Pressure \f$ P \f$
+      const CCTK_REAL ye     ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
   CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline range
   range_eps_from_valid_rho_ye(
       const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
@@ -115,6 +138,11 @@ CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_idealgas::eos_idealgas(
 CCTK_HOST CCTK_DEVICE
     CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_idealgas::~eos_idealgas() {}
 
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline const eos_idealgas &
+eos_idealgas::with_temp_guess(const CCTK_REAL temp) const {
+  return *this;
+}
+
 CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
 eos_idealgas::press_from_valid_rho_eps_ye(const CCTK_REAL rho,
                                           const CCTK_REAL eps,
@@ -173,6 +201,34 @@ eos_idealgas::eps_from_valid_rho_temp_ye(const CCTK_REAL rho,
   return temp / temp_over_eps;
 }
 
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+eos_idealgas::thermo_from_valid_rho_eps_ye(const CCTK_REAL rho,
+                                           const CCTK_REAL eps,
+                                           const CCTK_REAL ye) const {
+  eos_thermo th;
+  th.eps = eps;
+  th.press = gm1 * rho * eps;
+  th.h = 1 + gamma * eps;
+  th.cs2 = gamma * gm1 * eps / th.h;
+  th.dpdrho = gm1 * eps;
+  th.dpdeps = gm1 * rho;
+  return th;
+}
+
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+eos_idealgas::thermo_from_valid_rho_press_ye(const CCTK_REAL rho,
+                                             const CCTK_REAL press,
+                                             const CCTK_REAL ye) const {
+  eos_thermo th;
+  th.press = press;
+  th.eps = press / (rho * gm1);
+  th.h = 1 + th.eps + press / rho;
+  th.cs2 = gamma * press / (rho * th.h);
+  th.dpdrho = gm1 * th.eps;
+  th.dpdeps = gm1 * rho;
+  return th;
+}
+
 CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos::range
 eos_idealgas::range_eps_from_valid_rho_ye(const CCTK_REAL rho,
                                           const CCTK_REAL ye) const {
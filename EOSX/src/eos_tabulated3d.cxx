@@ -0,0 +1,335 @@
+#include <loop.hxx>
+
+#include <AMReX_GpuDevice.H>
+
+#include <cctk.h>
+#include <cctk_Arguments.h>
+#include <cctk_Parameters.h>
+
+#ifdef HAVE_CAPABILITY_HDF5
+#include <hdf5.h>
+#endif
+
+#ifdef HAVE_CAPABILITY_MPI
+#include <mpi.h>
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "eos_tabulated3d.hxx"
+#include "eos_tabulated3d_format.hxx"
+
+namespace EOSX {
+using namespace std;
+
+static_assert(sizeof(eos_tabulated3d_node) ==
+                  sizeof(eos_tabulated3d_file_node) &&
+              offsetof(eos_tabulated3d_node, dpderho) ==
+                  offsetof(eos_tabulated3d_file_node, dpderho),
+              "eos_tabulated3d_node must match the binary file layout");
+
+namespace {
+eos_tabulated3d eos_tab;
+eos_tabulated3d_float eos_tab_float;
+// Nodes of the current table, in double or reduced precision
+const void *eos_tab_nodes = nullptr;
+// Nodes copied to the AMReX arena, or nullptr if used in place
+void *eos_tab_nodes_alloc = nullptr;
+// Mapping of a binary table file
+void *eos_tab_mapping = nullptr;
+size_t eos_tab_mapping_size = 0;
+#ifdef HAVE_CAPABILITY_MPI
+// Node-shared window holding a table read from HDF5
+MPI_Win eos_tab_win = MPI_WIN_NULL;
+#endif
+} // namespace
+
+const eos_tabulated3d &get_eos_tabulated3d() {
+  if (!eos_tab.nodes)
+    CCTK_ERROR("No tabulated EOS has been read; set EOSX::evolution_eos = "
+               "\"Tabulated\" and EOSX::tabulated_eos_filename");
+  return eos_tab;
+}
+
+const eos_tabulated3d_float &get_eos_tabulated3d_float() {
+  if (!eos_tab_float.nodes)
+    CCTK_ERROR("No reduced precision tabulated EOS has been read; set "
+               "EOSX::tabulated_eos_reduced_precision");
+  return eos_tab_float;
+}
+
+void set_eos(const eos_tabulated3d &e) { eos_tab = e; }
+void set_eos(const eos_tabulated3d_float &e) { eos_tab_float = e; }
+
+/// Make the given nodes the current table. Nodes that are not accessible
+/// by the device or that do not outlive the table are copied.
+template <typename T>
+void set_eos_tabulated3d(const eos_tabulated3d_file_header &h,
+                         const eos_tabulated3d_node_t<T> *nodes,
+                         const bool in_place) {
+  const size_t bytes = h.num_nodes() * sizeof *nodes;
+#ifdef AMREX_USE_GPU
+  const bool copy = true;
+#else
+  const bool copy = !in_place;
+#endif
+  if (copy) {
+    eos_tab_nodes_alloc = amrex::The_Arena()->alloc(bytes);
+    amrex::Gpu::htod_memcpy(eos_tab_nodes_alloc, nodes, bytes);
+    eos_tab_nodes = eos_tab_nodes_alloc;
+  } else {
+    eos_tab_nodes = nodes;
+  }
+
+  const auto axis = [](int n, CCTK_REAL x0, CCTK_REAL dx) {
+    return eos_tabulated3d_axis{n, x0, dx, 1 / dx};
+  };
+  const eos_tabulated3d_t<T> e(
+      axis(h.nrho, h.logrho0, h.dlogrho), axis(h.ntemp, h.logtemp0, h.dlogtemp),
+      axis(h.nye, h.ye0, h.dye), h.energy_shift,
+      eos::range(h.eps_min, h.eps_max),
+      static_cast<const eos_tabulated3d_node_t<T> *>(eos_tab_nodes));
+  set_eos(e);
+
+  CCTK_VINFO("Tabulated EOS: %d x %d x %d nodes (%.1f MB, %s, %s)",
+             int(h.nrho), int(h.ntemp), int(h.nye), bytes / 1.0e6,
+             sizeof(T) == sizeof(double) ? "double" : "reduced precision",
+             copy ? "copied" : "used in place");
+  CCTK_VINFO("  rho  in [%g, %g], T in [%g, %g] MeV, Ye in [%g, %g]",
+             e.rgrho.min, e.rgrho.max, e.rgtemp.min, e.rgtemp.max, e.rgye.min,
+             e.rgye.max);
+}
+
+/// Convert nodes to reduced precision
+void convert_nodes_float(const eos_tabulated3d_file_header &h,
+                         const eos_tabulated3d_node *nodes,
+                         eos_tabulated3d_node_float *nodes_float) {
+  for (size_t i = 0; i < h.num_nodes(); ++i) {
+    const auto &n = nodes[i];
+    nodes_float[i] = {n.logpress, n.logenergy, float(n.cs2),
+                      float(n.entropy), float(n.dpdrhoe), float(n.dpderho)};
+  }
+}
+
+/// Maximum error of the trilinear interpolation of the reduced precision
+/// table with respect to the double precision table, at the centres of all
+/// cells, relative to the largest magnitude of the quantity at the corners
+/// of the cell. Since the interpolation weights are positive and sum to
+/// one, this is bounded by the relative rounding error of the nodes, i.e.
+/// 2^-24 for quantities within the range of float.
+void validate_nodes_float(const eos_tabulated3d_file_header &h,
+                          const eos_tabulated3d_node *nodes,
+                          const eos_tabulated3d_node_float *nodes_float) {
+  DECLARE_CCTK_PARAMETERS;
+
+  const char *const names[4] = {"cs2", "entropy", "dpdrhoe", "dpderho"};
+  CCTK_REAL errs[4] = {0, 0, 0, 0};
+  const size_t stride_temp = h.nrho, stride_ye = size_t(h.nrho) * h.ntemp;
+  for (size_t iye = 0; iye + 1 < h.nye; ++iye)
+    for (size_t itemp = 0; itemp + 1 < h.ntemp; ++itemp)
+      for (size_t irho = 0; irho + 1 < h.nrho; ++irho) {
+        const size_t i0 = irho + stride_temp * itemp + stride_ye * iye;
+        CCTK_REAL val[4] = {0, 0, 0, 0}, val_float[4] = {0, 0, 0, 0},
+                  scale[4] = {0, 0, 0, 0};
+        for (int c = 0; c < 8; ++c) {
+          const size_t i = i0 + (c & 1) + stride_temp * ((c >> 1) & 1) +
+                           stride_ye * ((c >> 2) & 1);
+          const auto &n = nodes[i];
+          const auto &nf = nodes_float[i];
+          const CCTK_REAL v[4] = {n.cs2, n.entropy, n.dpdrhoe, n.dpderho};
+          const CCTK_REAL vf[4] = {nf.cs2, nf.entropy, nf.dpdrhoe,
+                                   nf.dpderho};
+          for (int q = 0; q < 4; ++q) {
+            val[q] += v[q] / 8;
+            val_float[q] += vf[q] / 8;
+            scale[q] = max(scale[q], fabs(v[q]));
+          }
+        }
+        for (int q = 0; q < 4; ++q) {
+          const CCTK_REAL err =
+              scale[q] > 0 ? fabs(val_float[q] - val[q]) / scale[q] : 0;
+          // Also catches values that overflow in single precision
+          errs[q] = isfinite(err) ? max(errs[q], err) : HUGE_VAL;
+        }
+      }
+
+  CCTK_INFO("  Reduced precision interpolation error (max relative):");
+  for (int q = 0; q < 4; ++q) {
+    CCTK_VINFO("    %-8s %.3e", names[q], double(errs[q]));
+    if (!(errs[q] <= tabulated_eos_reduced_precision_tolerance))
+      CCTK_VERROR("Reduced precision tabulated EOS: the interpolation error "
+                  "%g of %s exceeds tabulated_eos_reduced_precision_tolerance "
+                  "= %g",
+                  double(errs[q]), names[q],
+                  double(tabulated_eos_reduced_precision_tolerance));
+  }
+}
+
+/// Make the given double precision nodes the current table, converting them
+/// to reduced precision if tabulated_eos_reduced_precision is set
+void use_nodes(const eos_tabulated3d_file_header &h,
+               const eos_tabulated3d_node *nodes, const bool in_place) {
+  DECLARE_CCTK_PARAMETERS;
+  if (!tabulated_eos_reduced_precision) {
+    set_eos_tabulated3d(h, nodes, in_place);
+    return;
+  }
+  vector<eos_tabulated3d_node_float> nodes_float(h.num_nodes());
+  convert_nodes_float(h, nodes, nodes_float.data());
+  validate_nodes_float(h, nodes, nodes_float.data());
+  set_eos_tabulated3d(h, nodes_float.data(), false);
+}
+
+/// Map a table in the binary format of eos_tabulated3d_format.hxx. The file
+/// is mapped shared and read-only, so all processes on a node use the same
+/// physical pages of the page cache.
+void map_binary_table(const char *filename) {
+  const int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    CCTK_VERROR("Could not open tabulated EOS file \"%s\"", filename);
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+    CCTK_VERROR("Could not stat tabulated EOS file \"%s\"", filename);
+  void *const mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    CCTK_VERROR("Could not map tabulated EOS file \"%s\"", filename);
+  eos_tab_mapping = mapping;
+  eos_tab_mapping_size = st.st_size;
+
+  const auto &h = *static_cast<const eos_tabulated3d_file_header *>(mapping);
+  const string err = eos_tabulated3d_check_header(h, st.st_size);
+  if (!err.empty())
+    CCTK_VERROR("Tabulated EOS file \"%s\": %s", filename, err.c_str());
+
+  use_nodes(h,
+            reinterpret_cast<const eos_tabulated3d_node *>(
+                static_cast<const char *>(mapping) + h.nodes_offset),
+            true);
+}
+
+#if defined HAVE_CAPABILITY_HDF5 && defined HAVE_CAPABILITY_MPI
+/// Read an HDF5 table on one process per node and place it in an MPI-3
+/// shared memory window that all processes on the node use in place. A
+/// reduced precision table is converted by the reading process.
+template <typename T> void read_hdf5_table_node_shared(const char *filename) {
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL,
+                      &node_comm);
+  int node_rank;
+  MPI_Comm_rank(node_comm, &node_rank);
+
+  eos_tabulated3d_table t;
+  if (node_rank == 0) {
+    try {
+      t = eos_tabulated3d_read_stellarcollapse(filename);
+    } catch (const exception &e) {
+      CCTK_VERROR("Tabulated EOS: %s", e.what());
+    }
+  }
+  MPI_Bcast(&t.header, sizeof t.header, MPI_BYTE, 0, node_comm);
+
+  const size_t bytes =
+      t.header.num_nodes() * sizeof(eos_tabulated3d_node_t<T>);
+  void *base;
+  MPI_Win_allocate_shared(node_rank == 0 ? bytes : 0, 1, MPI_INFO_NULL,
+                          node_comm, &base, &eos_tab_win);
+  MPI_Win_fence(0, eos_tab_win);
+  if (node_rank == 0) {
+    if constexpr (is_same_v<T, CCTK_REAL>) {
+      memcpy(base, t.nodes.data(), bytes);
+    } else {
+      auto *const nodes_float = static_cast<eos_tabulated3d_node_float *>(base);
+      convert_nodes_float(t.header, t.nodes.data(), nodes_float);
+      validate_nodes_float(t.header, t.nodes.data(), nodes_float);
+    }
+  }
+  MPI_Win_fence(0, eos_tab_win);
+
+  MPI_Aint size;
+  int disp_unit;
+  void *nodes;
+  MPI_Win_shared_query(eos_tab_win, 0, &size, &disp_unit, &nodes);
+  MPI_Comm_free(&node_comm);
+
+  set_eos_tabulated3d(t.header,
+                      static_cast<const eos_tabulated3d_node_t<T> *>(nodes),
+                      true);
+}
+#endif
+
+/// Whether the file starts with the magic number of the binary format
+bool is_binary_table(const char *filename) {
+  char magic[sizeof eos_tabulated3d_file_magic] = {};
+  ifstream file(filename, ios::binary);
+  file.read(magic, sizeof magic);
+  return file &&
+         memcmp(magic, eos_tabulated3d_file_magic, sizeof magic) == 0;
+}
+
+extern "C" void EOSX_Setup_Tabulated3d(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_PARAMETERS;
+
+  if (CCTK_EQUALS(tabulated_eos_filename, ""))
+    CCTK_ERROR("EOSX::tabulated_eos_filename must be set for a tabulated EOS");
+
+  if (is_binary_table(tabulated_eos_filename)) {
+    map_binary_table(tabulated_eos_filename);
+    return;
+  }
+
+#if defined HAVE_CAPABILITY_HDF5 && defined HAVE_CAPABILITY_MPI
+  if (tabulated_eos_node_shared) {
+    if (tabulated_eos_reduced_precision)
+      read_hdf5_table_node_shared<float>(tabulated_eos_filename);
+    else
+      read_hdf5_table_node_shared<CCTK_REAL>(tabulated_eos_filename);
+    return;
+  }
+#endif
+
+#ifdef HAVE_CAPABILITY_HDF5
+  eos_tabulated3d_table t;
+  try {
+    t = eos_tabulated3d_read_stellarcollapse(tabulated_eos_filename);
+  } catch (const exception &e) {
+    CCTK_VERROR("Tabulated EOS: %s", e.what());
+  }
+  use_nodes(t.header, t.nodes.data(), false);
+#else
+  CCTK_ERROR("Reading HDF5 tabulated EOS files requires HDF5; please "
+             "configure Cactus with HDF5 or convert the table with "
+             "EOSX/src/util/eos_tabulated3d_convert");
+#endif
+}
+
+extern "C" void EOSX_Free_Tabulated3d(CCTK_ARGUMENTS) {
+  if (eos_tab_nodes_alloc)
+    amrex::The_Arena()->free(eos_tab_nodes_alloc);
+  if (eos_tab_mapping)
+    munmap(eos_tab_mapping, eos_tab_mapping_size);
+#ifdef HAVE_CAPABILITY_MPI
+  if (eos_tab_win != MPI_WIN_NULL)
+    MPI_Win_free(&eos_tab_win);
+#endif
+  eos_tab_nodes_alloc = nullptr;
+  eos_tab_mapping = nullptr;
+  eos_tab_nodes = nullptr;
+  eos_tab = eos_tabulated3d();
+  eos_tab_float = eos_tabulated3d_float();
+}
+
+} // namespace EOSX
@@ -0,0 +1,515 @@
+/*! \file eos_tabulated3d.hxx
+\brief Tabulated EOS in \f$ (\log\rho, \log T, Y_e) \f$
+
+The table is stored as an array of structures: all quantities of one table
+node are contiguous, so that a trilinear interpolation touches eight nodes
+and returns pressure, specific energy, sound speed etc. at once. The axes
+are uniformly spaced in \f$ \log\rho \f$, \f$ \log T \f$ and \f$ Y_e \f$.
+
+The temperature is recovered from \f$ \epsilon \f$ (or \f$ P \f$) by
+bisection over the temperature nodes of the table, followed by an exact
+linear inversion within the bracketing cell. This is bounded by the table
+and consistent with the trilinear interpolation used for the forward
+direction.
+
+If a temperature guess has been set with with_temp_guess(), e.g. the
+temperature of the same cell at the previous time step, the bracket is
+searched outwards from the cell of the guess with a doubling step instead.
+When the temperature changed little this needs only the two nodes of that
+cell. Guesses outside the table (or NaN) fall back to the bisection over
+the whole table.
+
+*/
+
+#ifndef EOS_TABULATED3D_HXX
+#define EOS_TABULATED3D_HXX
+
+#include <algorithm>
+#include <cmath>
+
+#include "eos.hxx"
+using namespace std;
+
+namespace EOSX {
+
+/// Quantities stored at one node of the table, in code units. Pressure and
+/// energy are always stored in double precision, the other quantities in
+/// precision T.
+template <typename T> struct eos_tabulated3d_node_t {
+  CCTK_REAL logpress;  ///< \f$ \log P \f$
+  CCTK_REAL logenergy; ///< \f$ \log(\epsilon + \epsilon_0) \f$
+  T cs2;               ///< Squared sound speed \f$ c_s^2 \f$
+  T entropy;           ///< Entropy per baryon in \f$ k_B \f$
+  T dpdrhoe;           ///< \f$ \partial P / \partial \rho |_\epsilon \f$
+  T dpderho;           ///< \f$ \partial P / \partial \epsilon |_\rho \f$
+};
+
+/// Node as read from a file
+using eos_tabulated3d_node = eos_tabulated3d_node_t<CCTK_REAL>;
+/// Node with cs2, entropy and pressure derivatives in single precision
+using eos_tabulated3d_node_float = eos_tabulated3d_node_t<float>;
+
+/// Uniformly spaced table axis
+struct eos_tabulated3d_axis {
+  int n;          ///< Number of nodes
+  CCTK_REAL x0;   ///< First node
+  CCTK_REAL dx;   ///< Spacing
+  CCTK_REAL idx;  ///< Inverse spacing
+
+  /// Last node
+  CCTK_DEVICE CCTK_HOST CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  x1() const {
+    return x0 + (n - 1) * dx;
+  }
+
+  /// Find the cell containing x and the weight of its upper node. Points
+  /// outside the axis are clamped to the boundary.
+  CCTK_DEVICE CCTK_HOST CCTK_ATTRIBUTE_ALWAYS_INLINE inline void
+  locate(const CCTK_REAL x, int &i, CCTK_REAL &w) const {
+    const CCTK_REAL s = (x - x0) * idx;
+    i = min(max(int(floor(s)), 0), n - 2);
+    w = min(max(s - i, CCTK_REAL(0)), CCTK_REAL(1));
+  }
+};
+
+template <typename T> class eos_tabulated3d_t : public eos {
+public:
+  typedef eos_tabulated3d_node_t<T> node_type;
+
+  /// Not defined for a general EOS. Only present so that code written for
+  /// the ideal gas compiles; solvers relying on it must not be used.
+  CCTK_REAL gamma;
+  range rgeps; ///< Specific energy range over the whole table
+
+  eos_tabulated3d_axis ax_logrho;  ///< \f$ \log\rho \f$ axis
+  eos_tabulated3d_axis ax_logtemp; ///< \f$ \log T \f$ axis, T in MeV
+  eos_tabulated3d_axis ax_ye;      ///< \f$ Y_e \f$ axis
+  CCTK_REAL energy_shift;          ///< \f$ \epsilon_0 \f$
+  /// Table nodes, index irho + nrho * (itemp + ntemp * iye). Not owned.
+  const node_type *nodes;
+  /// Initial guess for the temperature inversion, NaN if there is none
+  CCTK_REAL logtemp_guess;
+
+  /// Position within the table at fixed density and electron fraction
+  struct rho_ye_loc {
+    int irho, iye;
+    CCTK_REAL wrho, wye;
+  };
+
+  // constructor
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_tabulated3d_t();
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_tabulated3d_t(
+      const eos_tabulated3d_axis &ax_logrho_,
+      const eos_tabulated3d_axis &ax_logtemp_,
+      const eos_tabulated3d_axis &ax_ye_, CCTK_REAL energy_shift_,
+      const range &rgeps_, const node_type *nodes_);
+
+  /// Copy of this EOS that starts temperature inversions at the given
+  /// temperature
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_tabulated3d_t
+  with_temp_guess(const CCTK_REAL temp ///< Temperature guess \f$ T \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  press_from_valid_rho_eps_ye(
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL eps, ///< Specific internal energy \f$ \epsilon \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  eps_from_valid_rho_press_ye(
+      const CCTK_REAL rho,   ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL press, ///< Pressure \f$ P \f$
+      const CCTK_REAL ye     ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  csnd_from_valid_rho_eps_ye(
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL eps, ///< Specific internal energy \f$ \epsilon \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  temp_from_valid_rho_eps_ye(
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL eps, ///< Specific internal energy \f$ \epsilon \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline void
+  press_derivs_from_valid_rho_eps_ye(
+      CCTK_REAL &press,  ///< Pressure \f$ P \f$
+      CCTK_REAL &dpdrho, ///< Partial derivative \f$ \frac{\partial P}{\partial
+                         ///< \rho} \f$
+      CCTK_REAL &dpdeps, ///< Partial derivative \f$ \frac{\partial P}{\partial
+                         ///< \epsilon} \f$
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL eps, ///< Specific internal energy \f$ \epsilon \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  entropy_from_valid_rho_temp_ye(
+      const CCTK_REAL rho,  ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL temp, ///< Temperature \f$ T \f$
+      const CCTK_REAL ye    ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  entropy_from_valid_rho_eps_ye(
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL eps, ///< Specific internal energy \f$ \epsilon \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  eps_from_valid_rho_temp_ye(
+      const CCTK_REAL rho,  ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL temp, ///< Temperature \f$ T \f$ in MeV
+      const CCTK_REAL ye    ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  /// Pressure, sound speed, enthalpy and pressure derivatives from a single
+  /// EOS evaluation
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+  thermo_from_valid_rho_eps_ye(
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL eps, ///< Specific internal energy \f$ \epsilon \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  /// Specific energy, sound speed, enthalpy and pressure derivatives from a
+  /// single EOS evaluation
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+  thermo_from_valid_rho_press_ye(
+      const CCTK_REAL rho,   ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL press, ///< Pressure \f$ P \f$
+      const CCTK_REAL ye     ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline range
+  range_eps_from_valid_rho_ye(
+      const CCTK_REAL rho, ///< Rest mass density  \f$ \rho \f$
+      const CCTK_REAL ye   ///< Electron fraction \f$ Y_e \f$
+  ) const;
+
+  /// All tabulated quantities at \f$ (\rho, \epsilon, Y_e) \f$ from a single
+  /// temperature inversion and trilinear lookup
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_tabulated3d_node
+  node_from_valid_rho_eps_ye(const CCTK_REAL rho, const CCTK_REAL eps,
+                             const CCTK_REAL ye, CCTK_REAL &logtemp) const;
+
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline rho_ye_loc
+  locate_rho_ye(const CCTK_REAL rho, const CCTK_REAL ye) const;
+
+  /// Bilinear interpolation in \f$ (\log\rho, Y_e) \f$ at temperature node
+  /// itemp of the member given by field
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  at_temp_node(CCTK_REAL node_type::*field, const rho_ye_loc &l,
+               const int itemp) const;
+
+  /// Invert the member given by field for \f$ \log T \f$, clamped to the
+  /// temperature range of the table. Starts at logtemp_guess if it is set.
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+  logtemp_from(CCTK_REAL node_type::*field, const rho_ye_loc &l,
+               const CCTK_REAL value) const;
+
+  /// Trilinear interpolation of all quantities
+  CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_tabulated3d_node
+  interp(const rho_ye_loc &l, const CCTK_REAL logtemp) const;
+};
+
+// constructor
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_tabulated3d_t<
+    T>::eos_tabulated3d_t()
+    : gamma(nan()), energy_shift(0), nodes(nullptr), logtemp_guess(nan()) {}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE
+    CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_tabulated3d_t<T>::eos_tabulated3d_t(
+        const eos_tabulated3d_axis &ax_logrho_,
+        const eos_tabulated3d_axis &ax_logtemp_,
+        const eos_tabulated3d_axis &ax_ye_, CCTK_REAL energy_shift_,
+        const range &rgeps_, const node_type *nodes_)
+    : gamma(nan()), rgeps(rgeps_), ax_logrho(ax_logrho_),
+      ax_logtemp(ax_logtemp_), ax_ye(ax_ye_), energy_shift(energy_shift_),
+      nodes(nodes_), logtemp_guess(nan()) {
+  set_range_rho(range(exp(ax_logrho.x0), exp(ax_logrho.x1())));
+  set_range_temp(range(exp(ax_logtemp.x0), exp(ax_logtemp.x1())));
+  set_range_ye(range(ax_ye.x0, ax_ye.x1()));
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE
+    CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_tabulated3d_t<T>
+    eos_tabulated3d_t<T>::with_temp_guess(const CCTK_REAL temp) const {
+  eos_tabulated3d_t r = *this;
+  r.logtemp_guess = log(temp);
+  return r;
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline
+    typename eos_tabulated3d_t<T>::rho_ye_loc
+    eos_tabulated3d_t<T>::locate_rho_ye(const CCTK_REAL rho,
+                                        const CCTK_REAL ye) const {
+  rho_ye_loc l;
+  ax_logrho.locate(log(rho), l.irho, l.wrho);
+  ax_ye.locate(ye, l.iye, l.wye);
+  return l;
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_tabulated3d_t<T>::at_temp_node(CCTK_REAL node_type::*field,
+                                   const rho_ye_loc &l, const int itemp) const {
+  const int nrho = ax_logrho.n;
+  const int stride_ye = nrho * ax_logtemp.n;
+  const node_type *const n0 = &nodes[l.irho + nrho * itemp + stride_ye * l.iye];
+  const node_type *const n1 = n0 + stride_ye;
+  return (1 - l.wye) * ((1 - l.wrho) * n0[0].*field + l.wrho * n0[1].*field) +
+         l.wye * ((1 - l.wrho) * n1[0].*field + l.wrho * n1[1].*field);
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_tabulated3d_t<T>::logtemp_from(CCTK_REAL node_type::*field,
+                                   const rho_ye_loc &l,
+                                   const CCTK_REAL value) const {
+  // The tabulated quantity is assumed to increase with temperature
+  const int n = ax_logtemp.n;
+  int lo = 0, hi = n - 1;
+  CCTK_REAL flo, fhi;
+  if (logtemp_guess >= ax_logtemp.x0 && logtemp_guess <= ax_logtemp.x1()) {
+    // Search outwards from the cell of the guess, doubling the step
+    CCTK_REAL w;
+    ax_logtemp.locate(logtemp_guess, lo, w);
+    hi = lo + 1;
+    flo = at_temp_node(field, l, lo);
+    fhi = at_temp_node(field, l, hi);
+    for (int step = 1; value < flo && lo > 0; step *= 2) {
+      hi = lo;
+      fhi = flo;
+      lo = max(lo - step, 0);
+      flo = at_temp_node(field, l, lo);
+    }
+    for (int step = 1; value >= fhi && hi < n - 1; step *= 2) {
+      lo = hi;
+      flo = fhi;
+      hi = min(hi + step, n - 1);
+      fhi = at_temp_node(field, l, hi);
+    }
+  } else {
+    flo = at_temp_node(field, l, lo);
+    fhi = at_temp_node(field, l, hi);
+  }
+  if (!(value > flo))
+    return ax_logtemp.x0 + lo * ax_logtemp.dx;
+  if (!(value < fhi))
+    return ax_logtemp.x0 + hi * ax_logtemp.dx;
+  while (hi - lo > 1) {
+    const int mid = (lo + hi) / 2;
+    const CCTK_REAL fmid = at_temp_node(field, l, mid);
+    if (fmid <= value) {
+      lo = mid;
+      flo = fmid;
+    } else {
+      hi = mid;
+      fhi = fmid;
+    }
+  }
+  const CCTK_REAL w = fhi > flo ? (value - flo) / (fhi - flo) : 0;
+  return ax_logtemp.x0 + (lo + w) * ax_logtemp.dx;
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE
+    CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_tabulated3d_node
+    eos_tabulated3d_t<T>::interp(const rho_ye_loc &l,
+                                 const CCTK_REAL logtemp) const {
+  int itemp;
+  CCTK_REAL wtemp;
+  ax_logtemp.locate(logtemp, itemp, wtemp);
+
+  const int nrho = ax_logrho.n;
+  const int stride_temp = nrho;
+  const int stride_ye = nrho * ax_logtemp.n;
+  const node_type *const n0 =
+      &nodes[l.irho + stride_temp * itemp + stride_ye * l.iye];
+
+  eos_tabulated3d_node r{0, 0, 0, 0, 0, 0};
+  for (int c = 0; c < 8; ++c) {
+    const int dr = c & 1, dt = (c >> 1) & 1, dy = (c >> 2) & 1;
+    const CCTK_REAL w = (dr ? l.wrho : 1 - l.wrho) *
+                        (dt ? wtemp : 1 - wtemp) * (dy ? l.wye : 1 - l.wye);
+    const node_type &n = n0[dr + stride_temp * dt + stride_ye * dy];
+    r.logpress += w * n.logpress;
+    r.logenergy += w * n.logenergy;
+    r.cs2 += w * n.cs2;
+    r.entropy += w * n.entropy;
+    r.dpdrhoe += w * n.dpdrhoe;
+    r.dpderho += w * n.dpderho;
+  }
+  return r;
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE
+    CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_tabulated3d_node
+    eos_tabulated3d_t<T>::node_from_valid_rho_eps_ye(const CCTK_REAL rho,
+                                                     const CCTK_REAL eps,
+                                                     const CCTK_REAL ye,
+                                                     CCTK_REAL &logtemp) const {
+  const rho_ye_loc l = locate_rho_ye(rho, ye);
+  logtemp = logtemp_from(&node_type::logenergy, l,
+                         log(max(eps + energy_shift, CCTK_REAL(0))));
+  return interp(l, logtemp);
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_tabulated3d_t<T>::press_from_valid_rho_eps_ye(const CCTK_REAL rho,
+                                                  const CCTK_REAL eps,
+                                                  const CCTK_REAL ye) const {
+  CCTK_REAL logtemp;
+  return exp(node_from_valid_rho_eps_ye(rho, eps, ye, logtemp).logpress);
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_tabulated3d_t<T>::eps_from_valid_rho_press_ye(const CCTK_REAL rho,
+                                                  const CCTK_REAL press,
+                                                  const CCTK_REAL ye) const {
+  const rho_ye_loc l = locate_rho_ye(rho, ye);
+  const CCTK_REAL logtemp =
+      logtemp_from(&node_type::logpress, l, log(press));
+  return exp(interp(l, logtemp).logenergy) - energy_shift;
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_tabulated3d_t<T>::csnd_from_valid_rho_eps_ye(const CCTK_REAL rho,
+                                                 const CCTK_REAL eps,
+                                                 const CCTK_REAL ye) const {
+  CCTK_REAL logtemp;
+  return sqrt(max(node_from_valid_rho_eps_ye(rho, eps, ye, logtemp).cs2,
+                  CCTK_REAL(0)));
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_tabulated3d_t<T>::temp_from_valid_rho_eps_ye(const CCTK_REAL rho,
+                                                 const CCTK_REAL eps,
+                                                 const CCTK_REAL ye) const {
+  const rho_ye_loc l = locate_rho_ye(rho, ye);
+  return exp(logtemp_from(&node_type::logenergy, l,
+                          log(max(eps + energy_shift, CCTK_REAL(0)))));
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline void
+eos_tabulated3d_t<T>::press_derivs_from_valid_rho_eps_ye(
+    CCTK_REAL &press, CCTK_REAL &dpdrho, CCTK_REAL &dpdeps, const CCTK_REAL rho,
+    const CCTK_REAL eps, const CCTK_REAL ye) const {
+  CCTK_REAL logtemp;
+  const eos_tabulated3d_node n =
+      node_from_valid_rho_eps_ye(rho, eps, ye, logtemp);
+  press = exp(n.logpress);
+  dpdrho = n.dpdrhoe;
+  dpdeps = n.dpderho;
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_tabulated3d_t<T>::entropy_from_valid_rho_temp_ye(const CCTK_REAL rho,
+                                                     const CCTK_REAL temp,
+                                                     const CCTK_REAL ye) const {
+  return interp(locate_rho_ye(rho, ye), log(temp)).entropy;
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_tabulated3d_t<T>::entropy_from_valid_rho_eps_ye(const CCTK_REAL rho,
+                                                    const CCTK_REAL eps,
+                                                    const CCTK_REAL ye) const {
+  CCTK_REAL logtemp;
+  return node_from_valid_rho_eps_ye(rho, eps, ye, logtemp).entropy;
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline CCTK_REAL
+eos_tabulated3d_t<T>::eps_from_valid_rho_temp_ye(const CCTK_REAL rho,
+                                                 const CCTK_REAL temp,
+                                                 const CCTK_REAL ye) const {
+  return exp(interp(locate_rho_ye(rho, ye), log(temp)).logenergy) -
+         energy_shift;
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+eos_tabulated3d_t<T>::thermo_from_valid_rho_eps_ye(const CCTK_REAL rho,
+                                                   const CCTK_REAL eps,
+                                                   const CCTK_REAL ye) const {
+  CCTK_REAL logtemp;
+  const eos_tabulated3d_node n =
+      node_from_valid_rho_eps_ye(rho, eps, ye, logtemp);
+  eos_thermo th;
+  th.eps = eps;
+  th.press = exp(n.logpress);
+  th.cs2 = max(n.cs2, CCTK_REAL(0));
+  th.h = 1 + eps + th.press / rho;
+  th.dpdrho = n.dpdrhoe;
+  th.dpdeps = n.dpderho;
+  return th;
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos_thermo
+eos_tabulated3d_t<T>::thermo_from_valid_rho_press_ye(const CCTK_REAL rho,
+                                                     const CCTK_REAL press,
+                                                     const CCTK_REAL ye) const {
+  const rho_ye_loc l = locate_rho_ye(rho, ye);
+  const CCTK_REAL logtemp =
+      logtemp_from(&node_type::logpress, l, log(press));
+  const eos_tabulated3d_node n = interp(l, logtemp);
+  eos_thermo th;
+  th.press = exp(n.logpress);
+  th.eps = exp(n.logenergy) - energy_shift;
+  th.cs2 = max(n.cs2, CCTK_REAL(0));
+  th.h = 1 + th.eps + th.press / rho;
+  th.dpdrho = n.dpdrhoe;
+  th.dpdeps = n.dpderho;
+  return th;
+}
+
+template <typename T>
+CCTK_HOST CCTK_DEVICE CCTK_ATTRIBUTE_ALWAYS_INLINE inline eos::range
+eos_tabulated3d_t<T>::range_eps_from_valid_rho_ye(const CCTK_REAL rho,
+                                                  const CCTK_REAL ye) const {
+  const rho_ye_loc l = locate_rho_ye(rho, ye);
+  const auto field = &node_type::logenergy;
+  return range(exp(at_temp_node(field, l, 0)) - energy_shift,
+               exp(at_temp_node(field, l, ax_logtemp.n - 1)) - energy_shift);
+}
+
+/// Tabulated EOS with all quantities in double precision
+using eos_tabulated3d = eos_tabulated3d_t<CCTK_REAL>;
+/// Tabulated EOS with cs2, entropy and pressure derivatives in single
+/// precision
+using eos_tabulated3d_float = eos_tabulated3d_t<float>;
+
+/// The table read at startup (see parameter tabulated_eos_filename). Stops
+/// with an error if no table has been read.
+const eos_tabulated3d &get_eos_tabulated3d();
+
+/// The table read at startup if tabulated_eos_reduced_precision is set.
+/// Stops with an error if no such table has been read.
+const eos_tabulated3d_float &get_eos_tabulated3d_float();
+
+} // namespace EOSX
+
+#endif
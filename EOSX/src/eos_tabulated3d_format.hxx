@@ -0,0 +1,231 @@
+/*! \file eos_tabulated3d_format.hxx
+\brief Binary file format for eos_tabulated3d
+
+The file holds a table ready to be used by eos_tabulated3d, in code units
+(\f$ c = G = M_\odot = 1 \f$, temperature in MeV, natural logarithms):
+
+  - eos_tabulated3d_file_header at offset 0
+  - axis arrays \f$ \log\rho \f$, \f$ \log T \f$, \f$ Y_e \f$ (double) at
+    header.axes_offset
+  - table nodes (eos_tabulated3d_file_node, rho varying fastest) at
+    header.nodes_offset
+
+All sections are aligned to eos_tabulated3d_file_alignment, so that the
+nodes can be used in place after mapping the file into memory.
+
+This header does not depend on Cactus so that it can be used by the
+converter in util/. The HDF5 reader is only available if <hdf5.h> has been
+included before this file.
+*/
+
+#ifndef EOS_TABULATED3D_FORMAT_HXX
+#define EOS_TABULATED3D_FORMAT_HXX
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace EOSX {
+
+constexpr char eos_tabulated3d_file_magic[8] = {'E', 'O', 'S', 'X',
+                                                'T', '3', 'D', '\0'};
+constexpr std::uint32_t eos_tabulated3d_file_version = 1;
+constexpr std::uint64_t eos_tabulated3d_file_alignment = 4096;
+
+struct eos_tabulated3d_file_node {
+  double logpress, logenergy, cs2, entropy, dpdrhoe, dpderho;
+};
+
+struct eos_tabulated3d_file_header {
+  char magic[8];            ///< eos_tabulated3d_file_magic
+  std::uint32_t version;    ///< eos_tabulated3d_file_version
+  std::uint32_t node_size;  ///< sizeof(eos_tabulated3d_file_node)
+  std::uint32_t nrho, ntemp, nye, unused;
+  double logrho0, dlogrho;   ///< \f$ \log\rho \f$ axis
+  double logtemp0, dlogtemp; ///< \f$ \log T \f$ axis
+  double ye0, dye;           ///< \f$ Y_e \f$ axis
+  double energy_shift;       ///< \f$ \epsilon_0 \f$
+  double eps_min, eps_max;   ///< Specific energy range of the table
+  std::uint64_t axes_offset, nodes_offset, file_size;
+
+  std::uint64_t num_nodes() const {
+    return std::uint64_t(nrho) * ntemp * nye;
+  }
+};
+
+/// Table in memory, as read from an HDF5 file
+struct eos_tabulated3d_table {
+  eos_tabulated3d_file_header header;
+  std::vector<double> logrho, logtemp, ye;
+  std::vector<eos_tabulated3d_file_node> nodes;
+};
+
+inline std::uint64_t eos_tabulated3d_align(const std::uint64_t offset) {
+  const std::uint64_t a = eos_tabulated3d_file_alignment;
+  return (offset + a - 1) / a * a;
+}
+
+/// Validate a header read from a file of the given size. Returns an empty
+/// string on success and a description of the problem otherwise.
+inline std::string
+eos_tabulated3d_check_header(const eos_tabulated3d_file_header &h,
+                             const std::uint64_t file_size) {
+  if (file_size < sizeof h ||
+      std::memcmp(h.magic, eos_tabulated3d_file_magic, sizeof h.magic) != 0)
+    return "not an EOSX tabulated EOS file";
+  if (h.version != eos_tabulated3d_file_version)
+    return "unsupported file version " + std::to_string(h.version);
+  if (h.node_size != sizeof(eos_tabulated3d_file_node))
+    return "unexpected node size " + std::to_string(h.node_size);
+  if (h.nrho < 2 || h.ntemp < 2 || h.nye < 2)
+    return "table needs at least 2 points per axis";
+  if (h.axes_offset % eos_tabulated3d_file_alignment != 0 ||
+      h.nodes_offset % eos_tabulated3d_file_alignment != 0)
+    return "sections are not aligned";
+  if (h.file_size != file_size ||
+      h.nodes_offset + h.num_nodes() * h.node_size > file_size)
+    return "file is truncated";
+  return "";
+}
+
+/// Build the uniform axis description from the node coordinates
+inline void eos_tabulated3d_axis_spacing(const char *name,
+                                         const std::vector<double> &x,
+                                         double &x0, double &dx) {
+  const std::size_t n = x.size();
+  if (n < 2)
+    throw std::runtime_error(std::string("axis \"") + name +
+                             "\" needs at least 2 points");
+  x0 = x[0];
+  dx = (x[n - 1] - x[0]) / (n - 1);
+  for (std::size_t i = 0; i < n; ++i)
+    if (std::fabs(x[i] - (x0 + i * dx)) > 1.0e-8 * std::fabs(dx) * n)
+      throw std::runtime_error(std::string("axis \"") + name +
+                               "\" is not uniformly spaced");
+}
+
+/// Write the table in the binary format
+inline void eos_tabulated3d_write(const std::string &filename,
+                                  eos_tabulated3d_table &t) {
+  auto &h = t.header;
+  std::memcpy(h.magic, eos_tabulated3d_file_magic, sizeof h.magic);
+  h.version = eos_tabulated3d_file_version;
+  h.node_size = sizeof(eos_tabulated3d_file_node);
+  h.unused = 0;
+  h.axes_offset = eos_tabulated3d_align(sizeof h);
+  h.nodes_offset = eos_tabulated3d_align(
+      h.axes_offset + (h.nrho + h.ntemp + h.nye) * sizeof(double));
+  h.file_size = h.nodes_offset + h.num_nodes() * h.node_size;
+
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  const auto write_at = [&](const std::uint64_t offset, const void *data,
+                            const std::size_t bytes) {
+    file.seekp(offset);
+    file.write(static_cast<const char *>(data), bytes);
+  };
+  write_at(0, &h, sizeof h);
+  std::uint64_t offset = h.axes_offset;
+  for (const auto *x : {&t.logrho, &t.logtemp, &t.ye}) {
+    write_at(offset, x->data(), x->size() * sizeof(double));
+    offset += x->size() * sizeof(double);
+  }
+  write_at(h.nodes_offset, t.nodes.data(), h.num_nodes() * h.node_size);
+  if (!file)
+    throw std::runtime_error("could not write \"" + filename + "\"");
+}
+
+#ifdef H5_VERS_MAJOR
+/// Read a table in the format of stellarcollapse.org and convert it to code
+/// units
+inline eos_tabulated3d_table
+eos_tabulated3d_read_stellarcollapse(const std::string &filename) {
+  // Conversion from CGS to code units (c = G = M_sun = 1)
+  const double rho_cgs_to_code = 1.61887093132742e-18;
+  const double press_cgs_to_code = 1.80123683248503e-39;
+  const double eps_cgs_to_code = 1.11265005605362e-21;
+
+  const hid_t file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if (file < 0)
+    throw std::runtime_error("could not open \"" + filename + "\"");
+
+  const auto read = [&](const char *name, auto *data) {
+    const hid_t type =
+        sizeof *data == sizeof(int) ? H5T_NATIVE_INT : H5T_NATIVE_DOUBLE;
+    const hid_t dset = H5Dopen2(file, name, H5P_DEFAULT);
+    if (dset < 0 ||
+        H5Dread(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0)
+      throw std::runtime_error(std::string("could not read dataset \"") +
+                               name + "\" from \"" + filename + "\"");
+    H5Dclose(dset);
+  };
+
+  int nrho, ntemp, nye;
+  read("pointsrho", &nrho);
+  read("pointstemp", &ntemp);
+  read("pointsye", &nye);
+  const std::size_t npoints = std::size_t(nrho) * ntemp * nye;
+
+  eos_tabulated3d_table t;
+  t.logrho.resize(nrho);
+  t.logtemp.resize(ntemp);
+  t.ye.resize(nye);
+  read("logrho", t.logrho.data());
+  read("logtemp", t.logtemp.data());
+  read("ye", t.ye.data());
+  double energy_shift;
+  read("energy_shift", &energy_shift);
+
+  // The datasets are stored with rho varying fastest, which is the node
+  // ordering of the binary format
+  std::vector<double> logpress(npoints), logenergy(npoints), cs2(npoints),
+      entropy(npoints), dpdrhoe(npoints), dpderho(npoints);
+  read("logpress", logpress.data());
+  read("logenergy", logenergy.data());
+  read("cs2", cs2.data());
+  read("entropy", entropy.data());
+  read("dpdrhoe", dpdrhoe.data());
+  read("dpderho", dpderho.data());
+  H5Fclose(file);
+
+  // log10 in CGS to natural log in code units
+  const double ln10 = std::log(10.0);
+  for (auto &x : t.logrho)
+    x = ln10 * x + std::log(rho_cgs_to_code);
+  for (auto &x : t.logtemp)
+    x = ln10 * x;
+
+  auto &h = t.header;
+  h.nrho = nrho;
+  h.ntemp = ntemp;
+  h.nye = nye;
+  eos_tabulated3d_axis_spacing("logrho", t.logrho, h.logrho0, h.dlogrho);
+  eos_tabulated3d_axis_spacing("logtemp", t.logtemp, h.logtemp0, h.dlogtemp);
+  eos_tabulated3d_axis_spacing("ye", t.ye, h.ye0, h.dye);
+  h.energy_shift = energy_shift * eps_cgs_to_code;
+
+  t.nodes.resize(npoints);
+  h.eps_min = HUGE_VAL;
+  h.eps_max = -HUGE_VAL;
+  for (std::size_t i = 0; i < npoints; ++i) {
+    auto &n = t.nodes[i];
+    n.logpress = ln10 * logpress[i] + std::log(press_cgs_to_code);
+    n.logenergy = ln10 * logenergy[i] + std::log(eps_cgs_to_code);
+    n.cs2 = cs2[i] * eps_cgs_to_code;
+    n.entropy = entropy[i];
+    n.dpdrhoe = dpdrhoe[i] * (press_cgs_to_code / rho_cgs_to_code);
+    n.dpderho = dpderho[i] * (press_cgs_to_code / eps_cgs_to_code);
+    const double eps = std::exp(n.logenergy) - h.energy_shift;
+    h.eps_min = std::fmin(h.eps_min, eps);
+    h.eps_max = std::fmax(h.eps_max, eps);
+  }
+  return t;
+}
+#endif
+
+} // namespace EOSX
+
+#endif
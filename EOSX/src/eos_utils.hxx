@@ -34,6 +34,16 @@ struct eos_range {
   }
 };
 
+/// Thermodynamic state returned by the batched EOS calls
+struct eos_thermo {
+  CCTK_REAL press;  ///< Pressure \f$ P \f$
+  CCTK_REAL eps;    ///< Specific internal energy \f$ \epsilon \f$
+  CCTK_REAL cs2;    ///< Squared sound speed \f$ c_s^2 \f$
+  CCTK_REAL h;      ///< Specific enthalpy \f$ h = 1 + \epsilon + P/\rho \f$
+  CCTK_REAL dpdrho; ///< \f$ \partial P / \partial \rho |_\epsilon \f$
+  CCTK_REAL dpdeps; ///< \f$ \partial P / \partial \epsilon |_\rho \f$
+};
+
 // TODO: add enums for error messages
 /// Class representing error conditions in EOS calls.
 struct eos_status {
@@ -0,0 +1,21 @@
+#include <cctk.h>
+#include <cctk_Arguments.h>
+#include <cctk_Parameters.h>
+
+namespace EOSX {
+
+extern "C" void EOSX_ParamCheck(CCTK_ARGUMENTS) {
+  DECLARE_CCTK_ARGUMENTS;
+  DECLARE_CCTK_PARAMETERS;
+
+  /* eos_hybrid::piece counts the thresholds below rho, which selects the
+   * right segment only if they are increasing */
+  for (int i = 1; i < hybrid_n_pieces - 1; ++i)
+    if (!(hybrid_rho_b[i] > hybrid_rho_b[i - 1]))
+      CCTK_VPARAMWARN("hybrid_rho_b must be increasing, but hybrid_rho_b[%d] "
+                      "= %g is not larger than hybrid_rho_b[%d] = %g",
+                      i, double(hybrid_rho_b[i]), i - 1,
+                      double(hybrid_rho_b[i - 1]));
+}
+
+} // namespace EOSX
@@ -0,0 +1,35 @@
+// Convert a stellarcollapse.org HDF5 EOS table to the binary format that
+// EOSX maps into memory (see eos_tabulated3d_format.hxx). Build with e.g.
+//
+//   h5c++ -std=c++17 -O2 -o eos_tabulated3d_convert eos_tabulated3d_convert.cxx
+//
+// and run as
+//
+//   eos_tabulated3d_convert <table.h5> <table.eosx>
+
+#include <hdf5.h>
+
+#include <cstdio>
+#include <exception>
+
+#include "../eos_tabulated3d_format.hxx"
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    std::fprintf(stderr, "Usage: %s <table.h5> <table.eosx>\n", argv[0]);
+    return 1;
+  }
+
+  try {
+    EOSX::eos_tabulated3d_table t =
+        EOSX::eos_tabulated3d_read_stellarcollapse(argv[1]);
+    EOSX::eos_tabulated3d_write(argv[2], t);
+    const auto &h = t.header;
+    std::printf("%s: %u x %u x %u nodes, %llu bytes\n", argv[2], h.nrho,
+                h.ntemp, h.nye, (unsigned long long)h.file_size);
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s: %s\n", argv[0], e.what());
+    return 1;
+  }
+  return 0;
+}
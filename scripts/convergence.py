@@ -0,0 +1,238 @@
+'''
+This file runs a convergence study of AsterX: a test problem with a known
+exact solution (sound wave, Alfven wave, magnetic loop advection) is run at
+several resolutions with every combination of reconstruction method, flux
+type and reconstructed velocity. AsterSeeds computes the difference to the
+exact solution in-situ (AsterSeeds::compute_errors), and CarpetX writes its
+L1 norm. The result is a CSV file with the error versus the CPU seconds of
+every run, i.e. the accuracy per cost of each scheme.
+
+Example:
+    python3 convergence.py --exe exe/cactus_sim --problem "Alfven wave" \\
+        --ncells 16 32 64 128 --reconstruction minmod ppm wenoz \\
+        --mpirun "mpirun -np 2" --output alfven.csv
+'''
+
+import argparse
+import csv
+import glob
+import itertools
+import math
+import os
+import re
+import resource
+import shlex
+import subprocess
+import time
+
+# Domain, final time and reported error of every problem. The 1D problems
+# are periodic along x, with three cells of the same size along y and z.
+PROBLEMS = {
+    "sound wave": dict(test_type="1DTest", length=2.0, dims=1,
+                       final_time=1.0, gamma=2.0, error="velx_error"),
+    "Alfven wave": dict(test_type="1DTest", length=1.0, dims=1,
+                        final_time=2.0, gamma=5.0/3.0, error="Bvecy_error"),
+    "magnetic loop advection": dict(test_type="2DTest", length=1.0, dims=2,
+                                    final_time=1.0, gamma=5.0/3.0,
+                                    error="Bvecx_error"),
+}
+
+PARFILE = '''
+ActiveThorns = "
+    CarpetX
+    IOUtil
+    ODESolvers
+    ADMBaseX
+    HydroBaseX
+    TmunuBaseX
+    AsterSeeds
+    AsterX
+    EOSX
+"
+
+Cactus::presync_mode = "mixed-error"
+Cactus::terminate = "iteration"
+Cactus::cctk_itlast = {itlast}
+
+ADMBaseX::initial_data = "Cartesian Minkowski"
+ADMBaseX::initial_lapse = "one"
+ADMBaseX::initial_shift = "zero"
+ADMBaseX::initial_dtlapse = "none"
+ADMBaseX::initial_dtshift = "none"
+
+CarpetX::verbose = no
+CarpetX::xmin = {xmin}
+CarpetX::ymin = {ymin}
+CarpetX::zmin = {zmin}
+CarpetX::xmax = {xmax}
+CarpetX::ymax = {ymax}
+CarpetX::zmax = {zmax}
+CarpetX::ncells_x = {ncells_x}
+CarpetX::ncells_y = {ncells_y}
+CarpetX::ncells_z = {ncells_z}
+CarpetX::periodic_x = yes
+CarpetX::periodic_y = yes
+CarpetX::periodic_z = yes
+CarpetX::boundary_x = "none"
+CarpetX::boundary_y = "none"
+CarpetX::boundary_z = "none"
+CarpetX::boundary_upper_x = "none"
+CarpetX::boundary_upper_y = "none"
+CarpetX::boundary_upper_z = "none"
+
+CarpetX::max_num_levels = 1
+CarpetX::regrid_every = 0
+CarpetX::blocking_factor_x = 1
+CarpetX::blocking_factor_y = 1
+CarpetX::blocking_factor_z = 1
+CarpetX::ghost_size = 3
+CarpetX::dtfac = {dtfac}
+
+AsterSeeds::test_type = "{test_type}"
+AsterSeeds::test_case = "{problem}"
+AsterSeeds::compute_errors = yes
+AsterSeeds::loop_period = {length}
+
+AsterX::flux_type = "{flux_type}"
+AsterX::recon_type = "{recon_type}"
+AsterX::vector_potential_gauge = "algebraic"
+AsterX::local_estimate_error = "no"
+AsterX::update_tmunu = "no"
+
+ReconX::reconstruction_method = "{reconstruction}"
+
+Con2PrimFactory::c2p_prime = "Noble"
+Con2PrimFactory::c2p_second = "Palenzuela"
+Con2PrimFactory::c2p_tol = 1e-12
+Con2PrimFactory::max_iter = 100
+Con2PrimFactory::rho_abs_min = 1e-8
+
+EOSX::evolution_eos = "IdealGas"
+EOSX::gl_gamma = {gamma}
+EOSX::poly_gamma = {gamma}
+EOSX::rho_max = 1e8
+EOSX::eps_max = 1e8
+EOSX::eps_min = 1e-8
+
+ODESolvers::method = "{ode_method}"
+
+IO::out_dir = "{out_dir}"
+IO::out_every = 0
+CarpetX::out_norm_vars = "AsterSeeds::errors"
+CarpetX::out_norm_every = {itlast}
+'''
+
+
+def write_parfile(filename, problem, ncells, reconstruction, flux_type,
+                  recon_type, args):
+    '''
+        This function writes the parameter file of one run and returns the
+        directory of its output.
+    '''
+    setup = PROBLEMS[problem]
+    dx = setup["length"] / ncells
+    final_time = args.final_time or setup["final_time"]
+    itlast = max(1, math.ceil(final_time / (args.dtfac * dx)))
+    extent = [setup["length"] / 2] * setup["dims"]
+    extent += [1.5 * dx] * (3 - setup["dims"])
+    cells = [ncells] * setup["dims"] + [3] * (3 - setup["dims"])
+    out_dir = os.path.splitext(filename)[0]
+    with open(filename, "w") as fp:
+        fp.write(PARFILE.format(
+            itlast=itlast, dtfac=args.dtfac, ode_method=args.ode_method,
+            xmin=-extent[0], ymin=-extent[1], zmin=-extent[2],
+            xmax=extent[0], ymax=extent[1], zmax=extent[2],
+            ncells_x=cells[0], ncells_y=cells[1], ncells_z=cells[2],
+            test_type=setup["test_type"], problem=problem,
+            length=setup["length"], gamma=setup["gamma"],
+            flux_type=flux_type, recon_type=recon_type,
+            reconstruction=reconstruction, out_dir=out_dir))
+    return out_dir
+
+
+def run(parfile, args):
+    '''
+        This function runs Cactus on a parameter file and returns the CPU
+        seconds of all its processes and the wall clock seconds.
+    '''
+    before = resource.getrusage(resource.RUSAGE_CHILDREN)
+    start = time.time()
+    command = shlex.split(args.mpirun) + [args.exe, parfile]
+    with open(os.path.splitext(parfile)[0] + ".log", "w") as log:
+        subprocess.run(command, stdout=log, stderr=subprocess.STDOUT,
+                       check=True)
+    wall = time.time() - start
+    after = resource.getrusage(resource.RUSAGE_CHILDREN)
+    cpu = (after.ru_utime - before.ru_utime) + (after.ru_stime - before.ru_stime)
+    return cpu, wall
+
+
+def read_error(out_dir, variable):
+    '''
+        This function reads the L1 norm of an error variable at the last
+        iteration from the norm output of CarpetX. The columns of the TSV
+        files are named e.g. "9:L1norm(AsterSeeds::velx_error)".
+    '''
+    pattern = re.compile(r"L1norm\(\w+::" + variable + r"\)$", re.IGNORECASE)
+    for filename in sorted(glob.glob(f"{out_dir}/**/*norm*.tsv",
+                                     recursive=True)):
+        with open(filename, "r") as fp:
+            lines = [line for line in fp.read().splitlines() if line.strip()]
+        header = lines[0].lstrip("#").split("\t")
+        for column, name in enumerate(header):
+            if pattern.search(name.strip()):
+                return float(lines[-1].split("\t")[column])
+    raise RuntimeError(f"No L1 norm of {variable} found in {out_dir}")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Error versus cost of the AsterX schemes")
+    parser.add_argument("--exe", required=True, help="Cactus executable")
+    parser.add_argument("--problem", choices=PROBLEMS.keys(),
+                        default="sound wave")
+    parser.add_argument("--ncells", type=int, nargs="+",
+                        default=[16, 32, 64, 128])
+    parser.add_argument("--reconstruction", nargs="+",
+                        default=["minmod", "monocentral", "ppm", "wenoz",
+                                 "mp5"])
+    parser.add_argument("--flux-type", nargs="+", default=["LxF", "HLLE"])
+    parser.add_argument("--recon-type", nargs="+",
+                        default=["v_vec", "z_vec", "s_vec"])
+    parser.add_argument("--error", help="error variable, e.g. rho_error")
+    parser.add_argument("--final-time", type=float)
+    parser.add_argument("--dtfac", type=float, default=0.25)
+    parser.add_argument("--ode-method", default="RK4")
+    parser.add_argument("--mpirun", default="",
+                        help="launcher command, e.g. \"mpirun -np 4\"")
+    parser.add_argument("--rundir", default="convergence")
+    parser.add_argument("--output", default="convergence.csv")
+    args = parser.parse_args()
+
+    variable = args.error or PROBLEMS[args.problem]["error"]
+    os.makedirs(args.rundir, exist_ok=True)
+    with open(args.output, "w", newline="") as fp:
+        writer = csv.writer(fp)
+        writer.writerow(["problem", "reconstruction_method", "flux_type",
+                         "recon_type", "ncells", "cpu_seconds",
+                         "wall_seconds", "L1_" + variable])
+        for reconstruction, flux_type, recon_type, ncells in \
+                itertools.product(args.reconstruction, args.flux_type,
+                                  args.recon_type, args.ncells):
+            name = "-".join([args.problem.replace(" ", "_"), reconstruction,
+                             flux_type, recon_type, str(ncells)])
+            parfile = os.path.join(args.rundir, name + ".par")
+            out_dir = write_parfile(parfile, args.problem, ncells,
+                                    reconstruction, flux_type, recon_type,
+                                    args)
+            cpu, wall = run(parfile, args)
+            error = read_error(out_dir, variable)
+            print(f"{name}: L1 error {error:.6e} in {cpu:.2f} CPU seconds")
+            writer.writerow([args.problem, reconstruction, flux_type,
+                             recon_type, ncells, f"{cpu:.3f}",
+                             f"{wall:.3f}", f"{error:.9e}"])
+            fp.flush()
+
+
+if __name__ == "__main__":
+    main()